@@ -0,0 +1,272 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** Profiler
+*/
+
+#include "Profiler/Profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace lava::profiler {
+
+namespace {
+
+struct Totals {
+    size_t count{0};
+    int64_t total{0};
+    int64_t self{0};
+    int64_t max{0};
+};
+
+/**
+ *  Events of one thread: the last `events.size()` ones are kept in a ring, the totals cover all of them.
+ *  A buffer is handed to a new thread once its thread exits, so short-lived workers (one per batch) share a
+ *  few buffers, which are the lanes of the trace.
+ */
+struct ThreadBuffer {
+    size_t lane{0};
+    std::vector<Event> events;
+    size_t written{0};
+    std::unordered_map<const char *, Totals> totals;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::vector<ThreadBuffer *> idle;
+    size_t capacity{DEFAULT_EVENTS_PER_THREAD};
+    std::atomic<int64_t> origin{0};
+};
+
+// Never destroyed: threads may still release their buffer during static destruction
+Registry &registry()
+{
+    static auto *instance = new Registry;
+    return *instance;
+}
+
+int64_t clockNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()
+    )
+        .count();
+}
+
+int64_t now()
+{
+    return clockNs() - registry().origin.load(std::memory_order_relaxed);
+}
+
+struct BufferLease {
+    ThreadBuffer *buffer{nullptr};
+
+    ~BufferLease()
+    {
+        if (buffer) {
+            auto &reg = registry();
+            std::lock_guard lock(reg.mutex);
+            reg.idle.push_back(buffer);
+        }
+    }
+};
+
+thread_local BufferLease lease;
+thread_local Scope *current = nullptr;
+
+ThreadBuffer &threadBuffer()
+{
+    if (!lease.buffer) {
+        auto &reg = registry();
+        std::lock_guard lock(reg.mutex);
+        if (reg.idle.empty()) {
+            reg.buffers.push_back(std::make_unique<ThreadBuffer>());
+            reg.buffers.back()->lane = reg.buffers.size() - 1;
+            reg.buffers.back()->events.resize(reg.capacity);
+            lease.buffer = reg.buffers.back().get();
+        } else {
+            lease.buffer = reg.idle.back();
+            reg.idle.pop_back();
+        }
+    }
+    return *lease.buffer;
+}
+
+std::string escape(const char *name)
+{
+    std::string escaped;
+    for (const char *c = name; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            escaped += '\\';
+        }
+        escaped += *c;
+    }
+    return escaped;
+}
+
+} // namespace
+
+void enable(size_t eventsPerThread)
+{
+    auto &reg = registry();
+    {
+        std::lock_guard lock(reg.mutex);
+        reg.capacity = std::max(eventsPerThread, size_t(1));
+        for (auto &buffer : reg.buffers) {
+            buffer->events.assign(reg.capacity, Event{});
+            buffer->written = 0;
+            buffer->totals.clear();
+        }
+    }
+    reg.origin.store(clockNs(), std::memory_order_relaxed);
+    detail::enabled.store(true, std::memory_order_release);
+}
+
+void disable()
+{
+    detail::enabled.store(false, std::memory_order_release);
+}
+
+void Scope::begin(const char *name) noexcept
+{
+    _name = name;
+    _parent = current;
+    current = this;
+    _start = now();
+}
+
+void Scope::end() noexcept
+{
+    const int64_t duration = now() - _start;
+    auto &buffer = threadBuffer();
+    buffer.events[buffer.written % buffer.events.size()] = {_name, _start, duration};
+    buffer.written++;
+
+    auto &totals = buffer.totals[_name];
+    totals.count++;
+    totals.total += duration;
+    totals.self += duration - _children;
+    totals.max = std::max(totals.max, duration);
+
+    if (_parent) {
+        _parent->_children += duration;
+    }
+    current = _parent;
+}
+
+std::vector<OpStats> summary()
+{
+    auto &reg = registry();
+    std::lock_guard lock(reg.mutex);
+
+    // The same name can be at different addresses in different translation units
+    std::map<std::string, OpStats> merged;
+    for (const auto &buffer : reg.buffers) {
+        for (const auto &[name, totals] : buffer->totals) {
+            auto &stats = merged[name];
+            stats.name = name;
+            stats.count += totals.count;
+            stats.total += totals.total;
+            stats.self += totals.self;
+            stats.max = std::max(stats.max, totals.max);
+        }
+    }
+
+    std::vector<OpStats> result;
+    for (auto &[name, stats] : merged) {
+        result.push_back(std::move(stats));
+    }
+    std::sort(result.begin(), result.end(), [](const OpStats &a, const OpStats &b) { return a.self > b.self; });
+    return result;
+}
+
+void printSummary(std::ostream &out)
+{
+    auto stats = summary();
+    int64_t totalSelf = 0;
+    for (const auto &op : stats) {
+        totalSelf += op.self;
+    }
+
+    size_t dropped = 0;
+    {
+        auto &reg = registry();
+        std::lock_guard lock(reg.mutex);
+        for (const auto &buffer : reg.buffers) {
+            dropped += buffer->written - std::min(buffer->written, buffer->events.size());
+        }
+    }
+
+    size_t width = 4;
+    for (const auto &op : stats) {
+        width = std::max(width, op.name.size() + 2);
+    }
+
+    auto flags = out.flags();
+    auto precision = out.precision();
+    out << "\nProfile (" << stats.size() << " ops, self time excludes nested scopes):" << std::endl;
+    const int nameWidth = static_cast<int>(width);
+    out << std::left << std::setw(nameWidth) << "Op" << std::right << std::setw(10) << "Calls" << std::setw(12)
+        << "Total ms" << std::setw(12) << "Self ms" << std::setw(8) << "Self %" << std::setw(12) << "Mean us"
+        << std::setw(12) << "Max us" << std::endl;
+    out << std::string(width + 66, '-') << std::endl;
+    out << std::fixed;
+    for (const auto &op : stats) {
+        out << std::left << std::setw(nameWidth) << op.name << std::right << std::setw(10) << op.count
+            << std::setprecision(2) << std::setw(12) << op.total / 1e6 << std::setw(12) << op.self / 1e6 << std::setprecision(1)
+            << std::setw(8) << (totalSelf ? 100.0 * op.self / totalSelf : 0.0) << std::setprecision(2)
+            << std::setw(12) << (op.count ? op.total / 1e3 / op.count : 0.0) << std::setw(12) << op.max / 1e3
+            << std::endl;
+    }
+    if (dropped > 0) {
+        out << dropped << " oldest events are missing from the trace (ring buffers full), the totals cover them"
+            << std::endl;
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void writeChromeTrace(const std::string &path)
+{
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open profile file: " + path);
+    }
+
+    auto &reg = registry();
+    std::lock_guard lock(reg.mutex);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    auto separator = [&]() {
+        file << (first ? "\n" : ",\n");
+        first = false;
+    };
+    file << std::fixed << std::setprecision(3);
+    for (const auto &buffer : reg.buffers) {
+        separator();
+        file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->lane
+             << ",\"args\":{\"name\":\"thread " << buffer->lane << "\"}}";
+
+        const size_t capacity = buffer->events.size();
+        const size_t kept = std::min(buffer->written, capacity);
+        for (size_t i = buffer->written - kept; i < buffer->written; i++) {
+            const auto &event = buffer->events[i % capacity];
+            separator();
+            file << "{\"name\":\"" << escape(event.name) << "\",\"cat\":\"lava\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+                 << buffer->lane << ",\"ts\":" << event.start / 1e3 << ",\"dur\":" << event.duration / 1e3 << "}";
+        }
+    }
+    file << "\n]}\n";
+}
+
+} // namespace lava::profiler
@@ -0,0 +1,110 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** Profiler
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace lava::profiler {
+
+/**
+ *  @brief Timed scope, in nanoseconds since the profiler was enabled.
+ */
+struct Event {
+    const char *name;
+    int64_t start;
+    int64_t duration;
+};
+
+/**
+ *  @brief Totals of every scope sharing a name, over all the threads.
+ */
+struct OpStats {
+    std::string name;
+    size_t count{0};
+    int64_t total{0}; /** Time inside the scopes, nested scopes included */
+    int64_t self{0}; /** Time inside the scopes minus the time of the nested scopes */
+    int64_t max{0};
+};
+
+constexpr size_t DEFAULT_EVENTS_PER_THREAD = 1 << 18;
+
+namespace detail {
+
+inline std::atomic<bool> enabled{false};
+
+} // namespace detail
+
+/**
+ *  @brief Starts recording the scopes. Each thread keeps its last @param eventsPerThread events for the
+ *         trace, the per-op totals cover every event.
+ */
+void enable(size_t eventsPerThread = DEFAULT_EVENTS_PER_THREAD);
+
+void disable();
+
+inline bool enabled()
+{
+    return detail::enabled.load(std::memory_order_relaxed);
+}
+
+/**
+ *  @brief Writes the recorded events to @param path in the Chrome trace format (chrome://tracing, Perfetto).
+ *
+ *  NOTE: Must not run while other threads are recording.
+ */
+void writeChromeTrace(const std::string &path);
+
+/**
+ *  @return The per-op totals, sorted by decreasing self time.
+ */
+std::vector<OpStats> summary();
+
+void printSummary(std::ostream &out);
+
+/**
+ *  @brief Times the enclosing scope when the profiler is enabled, costs one relaxed load otherwise.
+ *
+ *  @param name String literal: only the pointer is kept.
+ *
+ *  NOTE: Scopes of a thread nest, the innermost one is the current scope of the thread.
+ */
+class Scope {
+    public:
+    explicit Scope(const char *name) noexcept
+    {
+        if (enabled()) {
+            begin(name);
+        }
+    }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+    ~Scope()
+    {
+        if (_name) {
+            end();
+        }
+    }
+
+    private:
+    void begin(const char *name) noexcept;
+    void end() noexcept;
+
+    const char *_name{nullptr};
+    Scope *_parent{nullptr};
+    int64_t _start{0};
+    int64_t _children{0}; /** Time of the nested scopes */
+};
+
+} // namespace lava::profiler
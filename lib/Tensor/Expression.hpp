@@ -0,0 +1,295 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** Expression
+*/
+
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <format>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace lava {
+
+template <typename T>
+class TensorArray;
+
+/**
+ *  @brief Lazy element-wise arithmetic on TensorArray.
+ *
+ *  `a * b + c * 2` builds a tree of small nodes instead of a tensor per operator. The tree is evaluated
+ *  by a single loop over the elements, without intermediate tensors, when it becomes a TensorArray (a
+ *  construction, an assignment or a `TensorArray` argument) or the right-hand side of a compound
+ *  assignment.
+ *
+ *  Element i of the result combines the elements i of the operands, whatever their strides, and the
+ *  result has the shape and the strides of the leftmost tensor, as the eager operators had.
+ *
+ *  NOTE: Nodes reference their tensors: an expression must be evaluated in the statement that builds it
+ *        (`auto sum = a + b;` keeps an expression, not a tensor).
+ */
+namespace expr {
+
+/**
+ *  @brief Base of the expression nodes.
+ */
+struct Node {};
+
+template <typename E>
+struct IsTensorArray : std::false_type {};
+
+template <typename T>
+struct IsTensorArray<TensorArray<T>> : std::true_type {};
+
+/**
+ *  @brief A tensor or an expression node, the operands of the arithmetic operators.
+ */
+template <typename E>
+concept Operand = IsTensorArray<std::remove_cvref_t<E>>::value || std::derived_from<std::remove_cvref_t<E>, Node>;
+
+template <Operand E>
+using ValueType = typename std::remove_cvref_t<E>::value_type;
+
+struct Add {
+    template <typename T>
+    static T apply(T a, T b, bool &)
+    {
+        return a + b;
+    }
+};
+
+struct Sub {
+    template <typename T>
+    static T apply(T a, T b, bool &)
+    {
+        return a - b;
+    }
+};
+
+struct Mul {
+    template <typename T>
+    static T apply(T a, T b, bool &)
+    {
+        return a * b;
+    }
+};
+
+/**
+ *  @brief Records a zero divisor instead of throwing in the loop, which would keep it from vectorizing.
+ */
+struct Div {
+    template <typename T>
+    static T apply(T a, T b, bool &zeroDivisor)
+    {
+        zeroDivisor |= b == T{0};
+        return b == T{0} ? T{0} : a / b;
+    }
+};
+
+/**
+ *  @brief Leaf reading the elements of a tensor.
+ */
+template <typename T>
+class Ref : public Node {
+    public:
+    using value_type = T;
+
+    explicit Ref(const TensorArray<T> &tensor) : _tensor(&tensor), _datas(tensor.datas().data()) {}
+
+    T at(size_t i, bool &) const
+    {
+        return _datas[i];
+    }
+
+    const TensorArray<T> &source() const
+    {
+        return *_tensor;
+    }
+
+    /**
+     *  @brief Throws when the tensor has less than @param size elements.
+     */
+    void check(size_t size) const
+    {
+        size_t available = _tensor->datas().size();
+        if (available < size) {
+            throw std::out_of_range(
+                std::format("[ERR]: Index {} is out of range of tensor of size {}.", size, available)
+            );
+        }
+    }
+
+    private:
+    const TensorArray<T> *_tensor;
+    const T *_datas;
+};
+
+/**
+ *  @brief Leaf repeating a scalar, the right operand of the scalar operators.
+ */
+template <typename T>
+class Scalar : public Node {
+    public:
+    using value_type = T;
+
+    explicit Scalar(T value) : _value(value) {}
+
+    T at(size_t, bool &) const
+    {
+        return _value;
+    }
+
+    void check(size_t) const {}
+
+    private:
+    T _value;
+};
+
+template <typename Op, typename L, typename R>
+class Binary : public Node {
+    public:
+    using value_type = typename L::value_type;
+
+    Binary(L lhs, R rhs) : _lhs(std::move(lhs)), _rhs(std::move(rhs)) {}
+
+    value_type at(size_t i, bool &zeroDivisor) const
+    {
+        return Op::apply(_lhs.at(i, zeroDivisor), _rhs.at(i, zeroDivisor), zeroDivisor);
+    }
+
+    /**
+     *  @brief Tensor giving the shape and the strides of the result.
+     */
+    const TensorArray<value_type> &source() const
+    {
+        return _lhs.source();
+    }
+
+    void check(size_t size) const
+    {
+        _lhs.check(size);
+        _rhs.check(size);
+    }
+
+    private:
+    L _lhs;
+    R _rhs;
+};
+
+/**
+ *  @brief Node of @param operand: a tensor becomes a Ref leaf, a node is copied (nodes are small).
+ */
+template <typename T>
+Ref<T> node(const TensorArray<T> &operand)
+{
+    return Ref<T>(operand);
+}
+
+template <typename E>
+    requires std::derived_from<E, Node>
+E node(const E &operand)
+{
+    return operand;
+}
+
+template <Operand E>
+using NodeOf = decltype(node(std::declval<const std::remove_cvref_t<E> &>()));
+
+/**
+ *  @brief Writes the @param size first elements of @param expression to @param out in one loop.
+ *
+ *  NOTE: @param out may be one of the operands: element i is read before it is written, and only
+ *        element i is read to compute it.
+ */
+template <typename T, typename E>
+void evaluate(T *out, size_t size, const E &expression)
+{
+    expression.check(size);
+    bool zeroDivisor = false;
+    for (size_t i = 0; i < size; i++) {
+        out[i] = expression.at(i, zeroDivisor);
+    }
+    if (zeroDivisor) {
+        throw std::logic_error("[ERR] Zero division Error while doing a div operation.");
+    }
+}
+
+template <typename Op, Operand L, Operand R>
+    requires std::same_as<ValueType<L>, ValueType<R>>
+Binary<Op, NodeOf<L>, NodeOf<R>> combine(const L &lhs, const R &rhs)
+{
+    return {node(lhs), node(rhs)};
+}
+
+template <typename Op, Operand L>
+Binary<Op, NodeOf<L>, Scalar<ValueType<L>>> combine(const L &lhs, ValueType<L> k)
+{
+    return {node(lhs), Scalar<ValueType<L>>(k)};
+}
+
+} // namespace expr
+
+template <expr::Operand L, expr::Operand R>
+auto operator+(const L &lhs, const R &rhs)
+{
+    return expr::combine<expr::Add>(lhs, rhs);
+}
+
+template <expr::Operand L, expr::Operand R>
+auto operator-(const L &lhs, const R &rhs)
+{
+    return expr::combine<expr::Sub>(lhs, rhs);
+}
+
+template <expr::Operand L, expr::Operand R>
+auto operator*(const L &lhs, const R &rhs)
+{
+    return expr::combine<expr::Mul>(lhs, rhs);
+}
+
+template <expr::Operand L, expr::Operand R>
+auto operator/(const L &lhs, const R &rhs)
+{
+    return expr::combine<expr::Div>(lhs, rhs);
+}
+
+template <expr::Operand L>
+auto operator+(const L &lhs, std::type_identity_t<expr::ValueType<L>> k)
+{
+    return expr::combine<expr::Add>(lhs, k);
+}
+
+template <expr::Operand L>
+auto operator-(const L &lhs, std::type_identity_t<expr::ValueType<L>> k)
+{
+    return expr::combine<expr::Sub>(lhs, k);
+}
+
+template <expr::Operand L>
+auto operator*(const L &lhs, std::type_identity_t<expr::ValueType<L>> k)
+{
+    return expr::combine<expr::Mul>(lhs, k);
+}
+
+template <expr::Operand L>
+auto operator/(const L &lhs, std::type_identity_t<expr::ValueType<L>> k)
+{
+    return expr::combine<expr::Div>(lhs, k);
+}
+
+namespace expr {
+
+// Found by argument-dependent lookup when no operand is a TensorArray, eg. `(a * b) * 2`
+using lava::operator+;
+using lava::operator-;
+using lava::operator*;
+using lava::operator/;
+
+} // namespace expr
+
+} // namespace lava
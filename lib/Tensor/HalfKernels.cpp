@@ -0,0 +1,296 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** HalfKernels
+*/
+
+#include "Tensor/HalfKernels.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+
+namespace lava::kernels {
+
+namespace {
+
+uint16_t floatToBf16(float value)
+{
+    uint32_t bits = std::bit_cast<uint32_t>(value);
+    if ((bits & 0x7FFFFFFF) > 0x7F800000) {
+        return static_cast<uint16_t>((bits >> 16) | 0x40); // Quiet NaN, rounding could turn it into infinity
+    }
+    bits += 0x7FFF + ((bits >> 16) & 1);
+    return static_cast<uint16_t>(bits >> 16);
+}
+
+float bf16ToFloat(uint16_t value)
+{
+    return std::bit_cast<float>(static_cast<uint32_t>(value) << 16);
+}
+
+/**
+ *  Round to nearest even, subnormals are rounded by the float32 addition of a magic number.
+ */
+uint16_t floatToFp16(float value)
+{
+    constexpr uint32_t F32_INFINITY = 255u << 23;
+    constexpr uint32_t F16_OVERFLOW = (127u + 16) << 23;
+    constexpr uint32_t DENORMAL_MAGIC = ((127u - 15) + (23 - 10) + 1) << 23;
+
+    uint32_t bits = std::bit_cast<uint32_t>(value);
+    uint32_t sign = bits & 0x80000000;
+    bits ^= sign;
+
+    uint32_t half = 0;
+    if (bits >= F16_OVERFLOW) {
+        half = bits > F32_INFINITY ? 0x7E00 : 0x7C00;
+    } else if (bits < (113u << 23)) {
+        float rounded = std::bit_cast<float>(bits) + std::bit_cast<float>(DENORMAL_MAGIC);
+        half = std::bit_cast<uint32_t>(rounded) - DENORMAL_MAGIC;
+    } else {
+        uint32_t oddMantissa = (bits >> 13) & 1;
+        bits += ((15u - 127) << 23) + 0xFFF + oddMantissa;
+        half = bits >> 13;
+    }
+    return static_cast<uint16_t>(half | (sign >> 16));
+}
+
+float fp16ToFloat(uint16_t value)
+{
+    constexpr uint32_t SHIFTED_EXPONENT = 0x7C00u << 13;
+    constexpr float MAGIC = std::bit_cast<float>(113u << 23);
+
+    uint32_t bits = (value & 0x7FFFu) << 13;
+    uint32_t exponent = bits & SHIFTED_EXPONENT;
+    bits += (127u - 15) << 23;
+    if (exponent == SHIFTED_EXPONENT) {
+        bits += (128u - 16) << 23; // Infinity or NaN
+    } else if (exponent == 0) {
+        bits = std::bit_cast<uint32_t>(std::bit_cast<float>(bits + (1u << 23)) - MAGIC); // Subnormal
+    }
+    return std::bit_cast<float>(bits | (static_cast<uint32_t>(value & 0x8000) << 16));
+}
+
+void toHalfScalar(HalfFormat format, const float *src, uint16_t *dst, size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        dst[i] = floatToHalf(format, src[i]);
+    }
+}
+
+void fromHalfScalar(HalfFormat format, const uint16_t *src, float *dst, size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        dst[i] = halfToFloat(format, src[i]);
+    }
+}
+
+void gemvScalar(HalfFormat format, const float *x, const uint16_t *w, size_t rows, size_t cols, float *out)
+{
+    for (size_t r = 0; r < rows; r++) {
+        const uint16_t *row = w + r * cols;
+        float acc = 0.0f;
+        for (size_t k = 0; k < cols; k++) {
+            acc += x[k] * halfToFloat(format, row[k]);
+        }
+        out[r] = acc;
+    }
+}
+
+void gemvTransposedScalar(HalfFormat format, const float *g, const uint16_t *w, size_t rows, size_t cols, float *out)
+{
+    for (size_t k = 0; k < cols; k++) {
+        out[k] = 0.0f;
+    }
+    for (size_t r = 0; r < rows; r++) {
+        const uint16_t *row = w + r * cols;
+        for (size_t k = 0; k < cols; k++) {
+            out[k] += g[r] * halfToFloat(format, row[k]);
+        }
+    }
+}
+
+__attribute__((target("avx2,f16c"))) __m256 load8(HalfFormat format, const uint16_t *src)
+{
+    __m128i halves = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+    if (format == HalfFormat::FP16) {
+        return _mm256_cvtph_ps(halves);
+    }
+    return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(halves), 16));
+}
+
+__attribute__((target("avx2,f16c"))) void store8(HalfFormat format, __m256 values, uint16_t *dst)
+{
+    __m128i halves;
+    if (format == HalfFormat::FP16) {
+        halves = _mm256_cvtps_ph(values, _MM_FROUND_TO_NEAREST_INT);
+    } else {
+        __m256i bits = _mm256_castps_si256(values);
+        __m256i odd = _mm256_and_si256(_mm256_srli_epi32(bits, 16), _mm256_set1_epi32(1));
+        bits = _mm256_add_epi32(bits, _mm256_add_epi32(odd, _mm256_set1_epi32(0x7FFF)));
+        bits = _mm256_srli_epi32(bits, 16);
+        __m256 nan = _mm256_cmp_ps(values, values, _CMP_UNORD_Q);
+        bits = _mm256_blendv_epi8(bits, _mm256_set1_epi32(0x7FC0), _mm256_castps_si256(nan));
+        halves = _mm_packus_epi32(_mm256_castsi256_si128(bits), _mm256_extracti128_si256(bits, 1));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), halves);
+}
+
+__attribute__((target("avx2"))) float hsum256(__m256 v)
+{
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_movehdup_ps(sum));
+    return _mm_cvtss_f32(sum);
+}
+
+__attribute__((target("avx2,f16c"))) void toHalfAvx2(HalfFormat format, const float *src, uint16_t *dst, size_t size)
+{
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        store8(format, _mm256_loadu_ps(src + i), dst + i);
+    }
+    toHalfScalar(format, src + i, dst + i, size - i);
+}
+
+__attribute__((target("avx2,f16c"))) void fromHalfAvx2(HalfFormat format, const uint16_t *src, float *dst, size_t size)
+{
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        _mm256_storeu_ps(dst + i, load8(format, src + i));
+    }
+    fromHalfScalar(format, src + i, dst + i, size - i);
+}
+
+__attribute__((target("avx2,fma,f16c"))) void gemvAvx2(
+    HalfFormat format,
+    const float *x,
+    const uint16_t *w,
+    size_t rows,
+    size_t cols,
+    float *out
+)
+{
+    for (size_t r = 0; r < rows; r++) {
+        const uint16_t *row = w + r * cols;
+        __m256 acc = _mm256_setzero_ps();
+        size_t k = 0;
+        for (; k + 8 <= cols; k += 8) {
+            acc = _mm256_fmadd_ps(_mm256_loadu_ps(x + k), load8(format, row + k), acc);
+        }
+        float tail = 0.0f;
+        for (; k < cols; k++) {
+            tail += x[k] * halfToFloat(format, row[k]);
+        }
+        out[r] = hsum256(acc) + tail;
+    }
+}
+
+__attribute__((target("avx2,fma,f16c"))) void gemvTransposedAvx2(
+    HalfFormat format,
+    const float *g,
+    const uint16_t *w,
+    size_t rows,
+    size_t cols,
+    float *out
+)
+{
+    for (size_t k = 0; k < cols; k++) {
+        out[k] = 0.0f;
+    }
+    for (size_t r = 0; r < rows; r++) {
+        const uint16_t *row = w + r * cols;
+        __m256 factor = _mm256_set1_ps(g[r]);
+        size_t k = 0;
+        for (; k + 8 <= cols; k += 8) {
+            _mm256_storeu_ps(out + k, _mm256_fmadd_ps(factor, load8(format, row + k), _mm256_loadu_ps(out + k)));
+        }
+        for (; k < cols; k++) {
+            out[k] += g[r] * halfToFloat(format, row[k]);
+        }
+    }
+}
+
+HalfKernel detectHalfKernel()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && __builtin_cpu_supports("f16c")) {
+        return HalfKernel::AVX2;
+    }
+    return HalfKernel::SCALAR;
+}
+
+} // namespace
+
+HalfKernel halfKernel()
+{
+    static const HalfKernel kernel = detectHalfKernel();
+    return kernel;
+}
+
+const char *halfKernelName(HalfKernel kernel)
+{
+    switch (kernel) {
+        case HalfKernel::AVX2:
+            return "avx2-f16c";
+        case HalfKernel::SCALAR:
+            return "scalar";
+    }
+    return "unknown";
+}
+
+const char *halfFormatName(HalfFormat format)
+{
+    return format == HalfFormat::FP16 ? "fp16" : "bf16";
+}
+
+uint16_t floatToHalf(HalfFormat format, float value)
+{
+    return format == HalfFormat::FP16 ? floatToFp16(value) : floatToBf16(value);
+}
+
+float halfToFloat(HalfFormat format, uint16_t value)
+{
+    return format == HalfFormat::FP16 ? fp16ToFloat(value) : bf16ToFloat(value);
+}
+
+void toHalf(HalfFormat format, const float *src, uint16_t *dst, size_t size)
+{
+    if (halfKernel() == HalfKernel::AVX2) {
+        toHalfAvx2(format, src, dst, size);
+    } else {
+        toHalfScalar(format, src, dst, size);
+    }
+}
+
+void fromHalf(HalfFormat format, const uint16_t *src, float *dst, size_t size)
+{
+    if (halfKernel() == HalfKernel::AVX2) {
+        fromHalfAvx2(format, src, dst, size);
+    } else {
+        fromHalfScalar(format, src, dst, size);
+    }
+}
+
+void gemvHalf(HalfFormat format, const float *x, const uint16_t *w, size_t rows, size_t cols, float *out)
+{
+    if (halfKernel() == HalfKernel::AVX2) {
+        gemvAvx2(format, x, w, rows, cols, out);
+    } else {
+        gemvScalar(format, x, w, rows, cols, out);
+    }
+}
+
+void gemvHalfTransposed(HalfFormat format, const float *g, const uint16_t *w, size_t rows, size_t cols, float *out)
+{
+    if (halfKernel() == HalfKernel::AVX2) {
+        gemvTransposedAvx2(format, g, w, rows, cols, out);
+    } else {
+        gemvTransposedScalar(format, g, w, rows, cols, out);
+    }
+}
+
+} // namespace lava::kernels
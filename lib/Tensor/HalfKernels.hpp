@@ -0,0 +1,64 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** HalfKernels
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace lava::kernels {
+
+/**
+ *  @brief 16-bit floating point formats, stored as raw uint16_t bits.
+ *
+ *  bf16 keeps the float32 exponent range with 8 bits of mantissa, fp16 (IEEE half) has 11 bits of
+ *  mantissa but overflows above 65504, which is why fp16 gradients need loss scaling.
+ */
+enum class HalfFormat : uint32_t {
+    BF16 = 0,
+    FP16 = 1
+};
+
+/**
+ *  @brief Half precision implementations, the best one supported by the CPU is picked at runtime.
+ */
+enum class HalfKernel {
+    SCALAR,
+    AVX2 /** AVX2 with FMA and F16C */
+};
+
+HalfKernel halfKernel();
+
+const char *halfKernelName(HalfKernel kernel);
+
+const char *halfFormatName(HalfFormat format);
+
+/**
+ *  @brief Rounds @param value to the nearest @param format value, ties to even.
+ */
+uint16_t floatToHalf(HalfFormat format, float value);
+
+float halfToFloat(HalfFormat format, uint16_t value);
+
+void toHalf(HalfFormat format, const float *src, uint16_t *dst, size_t size);
+
+void fromHalf(HalfFormat format, const uint16_t *src, float *dst, size_t size);
+
+/**
+ *  @brief Matrix-vector product on half weights with float32 accumulation:
+ *         out[r] = sum_k x[k] * w[r * cols + k].
+ *
+ *  NOTE: The weights are converted in registers, they are read from memory at half the float32 size.
+ */
+void gemvHalf(HalfFormat format, const float *x, const uint16_t *w, size_t rows, size_t cols, float *out);
+
+/**
+ *  @brief Transposed matrix-vector product on half weights: out[k] = sum_r g[r] * w[r * cols + k].
+ */
+void gemvHalfTransposed(HalfFormat format, const float *g, const uint16_t *w, size_t rows, size_t cols, float *out);
+
+} // namespace lava::kernels
@@ -0,0 +1,166 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** Int8Kernels
+*/
+
+#include "Tensor/Int8Kernels.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+
+namespace lava::kernels {
+
+namespace {
+
+void gemvScalar(const int8_t *x, const int8_t *w, size_t rows, size_t stride, int32_t *out)
+{
+    for (size_t r = 0; r < rows; r++) {
+        const int8_t *row = w + r * stride;
+        int32_t acc = 0;
+        for (size_t k = 0; k < stride; k++) {
+            acc += static_cast<int32_t>(x[k]) * static_cast<int32_t>(row[k]);
+        }
+        out[r] = acc;
+    }
+}
+
+__attribute__((target("avx2"))) int32_t hsum256(__m256i v)
+{
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+}
+
+__attribute__((target("avx2"))) void gemvAvx2(
+    const int8_t *x,
+    const int8_t *w,
+    size_t rows,
+    size_t stride,
+    int32_t *out
+)
+{
+    const __m256i ones = _mm256_set1_epi16(1);
+
+    for (size_t r = 0; r < rows; r++) {
+        const int8_t *row = w + r * stride;
+        __m256i acc = _mm256_setzero_si256();
+        for (size_t k = 0; k < stride; k += 32) {
+            __m256i xv = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(x + k));
+            __m256i wv = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + k));
+            __m256i pairs = _mm256_maddubs_epi16(xv, wv);
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(pairs, ones));
+        }
+        out[r] = hsum256(acc);
+    }
+}
+
+__attribute__((target("avx2,avxvnni"))) void gemvAvxVnni(
+    const int8_t *x,
+    const int8_t *w,
+    size_t rows,
+    size_t stride,
+    int32_t *out
+)
+{
+    for (size_t r = 0; r < rows; r++) {
+        const int8_t *row = w + r * stride;
+        __m256i acc = _mm256_setzero_si256();
+        for (size_t k = 0; k < stride; k += 32) {
+            __m256i xv = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(x + k));
+            __m256i wv = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + k));
+            acc = _mm256_dpbusd_avx_epi32(acc, xv, wv);
+        }
+        out[r] = hsum256(acc);
+    }
+}
+
+__attribute__((target("avx2,avx512f,avx512bw,avx512vnni"))) void gemvAvx512Vnni(
+    const int8_t *x,
+    const int8_t *w,
+    size_t rows,
+    size_t stride,
+    int32_t *out
+)
+{
+    for (size_t r = 0; r < rows; r++) {
+        const int8_t *row = w + r * stride;
+        __m512i acc = _mm512_setzero_si512();
+        for (size_t k = 0; k < stride; k += 64) {
+            __m512i xv = _mm512_loadu_si512(x + k);
+            __m512i wv = _mm512_loadu_si512(row + k);
+            acc = _mm512_dpbusd_epi32(acc, xv, wv);
+        }
+        // Spilling the lanes avoids the 512-bit extract intrinsics, which trip -Wmaybe-uninitialized on GCC 12
+        alignas(64) int32_t lanes[16];
+        _mm512_store_si512(lanes, acc);
+        out[r] = hsum256(_mm256_add_epi32(_mm256_load_si256(reinterpret_cast<const __m256i *>(lanes)),
+            _mm256_load_si256(reinterpret_cast<const __m256i *>(lanes + 8))));
+    }
+}
+
+Int8Kernel detectInt8Kernel()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512vnni") && __builtin_cpu_supports("avx512bw")) {
+        return Int8Kernel::AVX512_VNNI;
+    }
+    if (__builtin_cpu_supports("avxvnni")) {
+        return Int8Kernel::AVX_VNNI;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return Int8Kernel::AVX2;
+    }
+    return Int8Kernel::SCALAR;
+}
+
+} // namespace
+
+Int8Kernel int8Kernel()
+{
+    static const Int8Kernel kernel = detectInt8Kernel();
+    return kernel;
+}
+
+const char *int8KernelName(Int8Kernel kernel)
+{
+    switch (kernel) {
+        case Int8Kernel::AVX512_VNNI:
+            return "avx512-vnni";
+        case Int8Kernel::AVX_VNNI:
+            return "avx-vnni";
+        case Int8Kernel::AVX2:
+            return "avx2";
+        case Int8Kernel::SCALAR:
+            return "scalar";
+    }
+    return "unknown";
+}
+
+void gemvInt8(Int8Kernel kernel, const int8_t *x, const int8_t *w, size_t rows, size_t stride, int32_t *out)
+{
+    switch (kernel) {
+        case Int8Kernel::AVX512_VNNI:
+            gemvAvx512Vnni(x, w, rows, stride, out);
+            break;
+        case Int8Kernel::AVX_VNNI:
+            gemvAvxVnni(x, w, rows, stride, out);
+            break;
+        case Int8Kernel::AVX2:
+            gemvAvx2(x, w, rows, stride, out);
+            break;
+        case Int8Kernel::SCALAR:
+            gemvScalar(x, w, rows, stride, out);
+            break;
+    }
+}
+
+void gemvInt8(const int8_t *x, const int8_t *w, size_t rows, size_t stride, int32_t *out)
+{
+    gemvInt8(int8Kernel(), x, w, rows, stride, out);
+}
+
+} // namespace lava::kernels
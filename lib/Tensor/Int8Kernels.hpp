@@ -0,0 +1,53 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** Int8Kernels
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace lava::kernels {
+
+/**
+ *  @brief Int8 dot-product implementations, the best one supported by the CPU is picked at runtime.
+ */
+enum class Int8Kernel {
+    SCALAR,
+    AVX2,
+    AVX_VNNI,
+    AVX512_VNNI
+};
+
+constexpr size_t INT8_ALIGNMENT = 64; /** Rows of int8 matrices are padded to this many elements */
+
+Int8Kernel int8Kernel();
+
+const char *int8KernelName(Int8Kernel kernel);
+
+inline size_t int8PaddedSize(size_t size)
+{
+    return (size + INT8_ALIGNMENT - 1) & ~(INT8_ALIGNMENT - 1);
+}
+
+/**
+ *  @brief Int8 matrix-vector product with int32 accumulation: out[r] = sum_k x[k] * w[r * stride + k].
+ *
+ *  @param x Input vector of `stride` elements, its values must be in [0, 127]
+ *  @param w Row-major matrix of `rows` rows of `stride` elements
+ *  @param stride Row length, a multiple of INT8_ALIGNMENT (pad with zeros)
+ *
+ *  NOTE: The SIMD kernels (VNNI `vpdpbusd`, AVX2 `vpmaddubsw`) multiply unsigned by signed bytes,
+ *        hence the non-negative input. With inputs in [0, 127] the AVX2 16-bit pair sums never saturate.
+ */
+void gemvInt8(const int8_t *x, const int8_t *w, size_t rows, size_t stride, int32_t *out);
+
+/**
+ *  @brief Same as gemvInt8() with an explicit @param kernel, which must be supported by the CPU.
+ */
+void gemvInt8(Int8Kernel kernel, const int8_t *x, const int8_t *w, size_t rows, size_t stride, int32_t *out);
+
+} // namespace lava::kernels
@@ -0,0 +1,153 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** Memory
+*/
+
+#include "Tensor/Memory.hpp"
+
+#include <atomic>
+#include <iomanip>
+#include <sstream>
+
+namespace lava::memory {
+
+namespace {
+
+struct Counters {
+    std::atomic<int64_t> live{0};
+    std::atomic<int64_t> peak{0};
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> frees{0};
+};
+
+std::array<Counters, CATEGORY_COUNT> categories;
+Counters total;
+
+void raisePeak(Counters &counters, int64_t live)
+{
+    int64_t peak = counters.peak.load(std::memory_order_relaxed);
+    while (live > peak && !counters.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+void add(Counters &counters, int64_t bytes)
+{
+    int64_t live = counters.live.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    if (bytes > 0) {
+        raisePeak(counters, live);
+    }
+}
+
+Usage usage(const Counters &counters)
+{
+    return {
+        counters.live.load(std::memory_order_relaxed),
+        counters.peak.load(std::memory_order_relaxed),
+        counters.allocations.load(std::memory_order_relaxed),
+        counters.frees.load(std::memory_order_relaxed)
+    };
+}
+
+std::string formatBytes(int64_t bytes)
+{
+    static constexpr const char *UNITS[] = {"B", "KiB", "MiB", "GiB"};
+    double value = static_cast<double>(bytes);
+    size_t unit = 0;
+    while ((value >= 1024 || value <= -1024) && unit + 1 < std::size(UNITS)) {
+        value /= 1024;
+        unit++;
+    }
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(unit == 0 ? 0 : 1) << value << " " << UNITS[unit];
+    return out.str();
+}
+
+} // namespace
+
+const char *categoryName(Category category)
+{
+    switch (category) {
+        case Category::TEMPORARIES:
+            return "temporaries";
+        case Category::WEIGHTS:
+            return "weights";
+        case Category::GRADS:
+            return "grads";
+        case Category::ACTIVATIONS:
+            return "activations";
+        case Category::SAVED:
+            return "autograd saved";
+        case Category::OPTIMIZER:
+            return "optimizer";
+        case Category::BATCHES:
+            return "batches";
+        case Category::COUNT:
+            break;
+    }
+    return "unknown";
+}
+
+void allocated(Category category, size_t bytes)
+{
+    auto &counters = categories[static_cast<size_t>(category)];
+    counters.allocations.fetch_add(1, std::memory_order_relaxed);
+    add(counters, static_cast<int64_t>(bytes));
+    total.allocations.fetch_add(1, std::memory_order_relaxed);
+    add(total, static_cast<int64_t>(bytes));
+}
+
+void freed(Category category, size_t bytes)
+{
+    auto &counters = categories[static_cast<size_t>(category)];
+    counters.frees.fetch_add(1, std::memory_order_relaxed);
+    add(counters, -static_cast<int64_t>(bytes));
+    total.frees.fetch_add(1, std::memory_order_relaxed);
+    add(total, -static_cast<int64_t>(bytes));
+}
+
+void retag(Category from, Category to, size_t bytes)
+{
+    if (from == to) {
+        return;
+    }
+    add(categories[static_cast<size_t>(from)], -static_cast<int64_t>(bytes));
+    add(categories[static_cast<size_t>(to)], static_cast<int64_t>(bytes));
+}
+
+void resetPeaks()
+{
+    for (auto &counters : categories) {
+        counters.peak.store(counters.live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    total.peak.store(total.live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+Report report()
+{
+    Report result;
+    for (size_t i = 0; i < CATEGORY_COUNT; i++) {
+        result.categories[i] = usage(categories[i]);
+    }
+    result.total = usage(total);
+    return result;
+}
+
+void printReport(std::ostream &out, const std::string &label)
+{
+    auto current = report();
+    out << label << " (live / peak):";
+    for (size_t i = 0; i < CATEGORY_COUNT; i++) {
+        const auto &category = current.categories[i];
+        if (category.allocations == 0 && category.live == 0) {
+            continue;
+        }
+        out << " " << categoryName(static_cast<Category>(i)) << " " << formatBytes(category.live) << " / "
+            << formatBytes(category.peak) << ",";
+    }
+    out << " total " << formatBytes(current.total.live) << " / " << formatBytes(current.total.peak) << " ("
+        << current.total.allocations << " allocations)" << std::endl;
+}
+
+} // namespace lava::memory
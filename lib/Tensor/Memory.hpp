@@ -0,0 +1,105 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** Memory
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace lava::memory {
+
+/**
+ *  @brief What an owned Storage holds. Allocations are tagged with the category of the calling thread.
+ */
+enum class Category : uint8_t {
+    TEMPORARIES = 0, /** Default: backward gradients, scratch buffers */
+    WEIGHTS,
+    GRADS, /** Gradient buffers of the tensors and gradient arenas */
+    ACTIVATIONS, /** Outputs of the layers during a forward pass */
+    SAVED, /** Tensors saved by the autograd nodes for the backward pass */
+    OPTIMIZER, /** Optimizer state: momentum and moment slots */
+    BATCHES, /** Training minibatch buffers */
+    COUNT
+};
+
+constexpr size_t CATEGORY_COUNT = static_cast<size_t>(Category::COUNT);
+
+const char *categoryName(Category category);
+
+struct Usage {
+    int64_t live{0}; /** Bytes currently allocated */
+    int64_t peak{0}; /** Highest live bytes since the last resetPeaks() */
+    uint64_t allocations{0};
+    uint64_t frees{0};
+};
+
+struct Report {
+    std::array<Usage, CATEGORY_COUNT> categories;
+    Usage total; /** Peak of the sum, not the sum of the peaks */
+};
+
+void allocated(Category category, size_t bytes);
+
+void freed(Category category, size_t bytes);
+
+/**
+ *  @brief Moves @param bytes already allocated from @param from to @param to, without counting
+ *         an allocation.
+ */
+void retag(Category from, Category to, size_t bytes);
+
+/**
+ *  @brief Sets the peaks to the live bytes, so the next report gives the peaks from now on.
+ */
+void resetPeaks();
+
+Report report();
+
+/**
+ *  @brief Prints live / peak bytes of every category that was used, after @param label.
+ */
+void printReport(std::ostream &out, const std::string &label);
+
+namespace detail {
+
+inline thread_local Category current = Category::TEMPORARIES;
+
+} // namespace detail
+
+inline Category currentCategory()
+{
+    return detail::current;
+}
+
+/**
+ *  @brief Tags the allocations of the calling thread with @param category until the scope ends.
+ *
+ *  NOTE: Scopes nest, the innermost one wins.
+ */
+class Scope {
+    public:
+    explicit Scope(Category category) : _previous(detail::current)
+    {
+        detail::current = category;
+    }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+    ~Scope()
+    {
+        detail::current = _previous;
+    }
+
+    private:
+    Category _previous;
+};
+
+} // namespace lava::memory
@@ -0,0 +1,128 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** Philox
+*/
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+
+namespace lava {
+
+/**
+ *  @brief Philox4x32-10 counter-based generator (Salmon et al., "Parallel random numbers: as easy as
+ *         1, 2, 3"): the block of 4 random words of a counter is a pure function of the counter and the key.
+ *
+ *  Element i of a filled range comes from lane i % 4 of block i / 4, so a range can be split between
+ *  threads in any way and still gets the same values. The rounds have no branches and no state, which
+ *  lets the compiler vectorize the fill loops.
+ */
+class Philox {
+    public:
+    using Block = std::array<uint32_t, 4>;
+
+    explicit Philox(uint64_t key) : _key{static_cast<uint32_t>(key), static_cast<uint32_t>(key >> 32)} {}
+
+    /**
+     *  @brief Key of the independent stream @param index of @param seed (eg. one per network, then one
+     *         per tensor of a network), mixed with splitmix64.
+     */
+    static uint64_t derive(uint64_t seed, uint64_t index)
+    {
+        uint64_t z = seed + (index + 1) * 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    Block operator()(uint64_t counter) const
+    {
+        Block c = {static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32), 0, 0};
+        uint32_t k0 = _key[0];
+        uint32_t k1 = _key[1];
+        for (int round = 0; round < ROUNDS; round++) {
+            uint64_t p0 = static_cast<uint64_t>(M0) * c[0];
+            uint64_t p1 = static_cast<uint64_t>(M1) * c[2];
+            c = {
+                static_cast<uint32_t>(p1 >> 32) ^ c[1] ^ k0,
+                static_cast<uint32_t>(p1),
+                static_cast<uint32_t>(p0 >> 32) ^ c[3] ^ k1,
+                static_cast<uint32_t>(p0)
+            };
+            k0 += W0;
+            k1 += W1;
+        }
+        return c;
+    }
+
+    /**
+     *  @brief Fills out[begin, end) with values uniform in [low, high).
+     */
+    template <typename T>
+    void uniform(T *out, size_t begin, size_t end, T low, T high) const
+    {
+        const double scale = static_cast<double>(high) - static_cast<double>(low);
+        forEachBlock(begin, end, [&](size_t first, const Block &block) {
+            for (size_t lane = 0; lane < 4; lane++) {
+                if (first + lane >= begin && first + lane < end) {
+                    out[first + lane] = static_cast<T>(low + scale * unit(block[lane]));
+                }
+            }
+        });
+    }
+
+    /**
+     *  @brief Fills out[begin, end) with normal values, two per pair of words (Box-Muller).
+     */
+    template <typename T>
+    void normal(T *out, size_t begin, size_t end, T mean, T stddev) const
+    {
+        forEachBlock(begin, end, [&](size_t first, const Block &block) {
+            std::array<double, 4> values;
+            for (size_t pair = 0; pair < 4; pair += 2) {
+                double radius = std::sqrt(-2.0 * std::log(unit(block[pair])));
+                double angle = 2.0 * std::numbers::pi * unit(block[pair + 1]);
+                values[pair] = radius * std::cos(angle);
+                values[pair + 1] = radius * std::sin(angle);
+            }
+            for (size_t lane = 0; lane < 4; lane++) {
+                if (first + lane >= begin && first + lane < end) {
+                    out[first + lane] = static_cast<T>(mean + stddev * values[lane]);
+                }
+            }
+        });
+    }
+
+    private:
+    static constexpr int ROUNDS = 10;
+    static constexpr uint32_t M0 = 0xD2511F53;
+    static constexpr uint32_t M1 = 0xCD9E8D57;
+    static constexpr uint32_t W0 = 0x9E3779B9;
+    static constexpr uint32_t W1 = 0xBB67AE85;
+
+    /**
+     *  @return @param word mapped to (0, 1), never 0 so that its logarithm is finite.
+     */
+    static double unit(uint32_t word)
+    {
+        return (static_cast<double>(word) + 0.5) * 0x1p-32;
+    }
+
+    template <typename Fn>
+    void forEachBlock(size_t begin, size_t end, Fn &&fn) const
+    {
+        for (size_t block = begin / 4; block * 4 < end; block++) {
+            fn(block * 4, (*this)(block));
+        }
+    }
+
+    std::array<uint32_t, 2> _key;
+};
+
+} // namespace lava
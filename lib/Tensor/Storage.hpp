@@ -0,0 +1,277 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** Storage
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include "Profiler/Profiler.hpp"
+#include "Tensor/Memory.hpp"
+
+namespace lava {
+
+/**
+ *  @tparam Type of the elements stored.
+ *
+ *  @brief Flat 64-byte aligned buffer backing a TensorArray.
+ *
+ *  A Storage either owns its memory or is a view on memory owned by someone else
+ *  (eg. a memory-mapped network file). The optional owner handle keeps that memory alive
+ *  as long as the view exists.
+ *
+ *  Owned buffers are accounted in the memory category of the thread that allocated them
+ *  (see memory::Scope), views are not.
+ *
+ *  NOTE: Copying a Storage always produces an owned buffer. Copy-assigning into a Storage of
+ *        the same size writes in place, so a view stays bound to its memory. A read-only view
+ *        (see readOnlyView()) gets its own buffer instead, its memory is never written.
+ */
+template <typename T>
+class Storage {
+    static_assert(std::is_trivially_copyable_v<T>, "Storage only supports trivially copyable types");
+
+    public:
+    static constexpr size_t ALIGNMENT = 64;
+
+    using value_type = T;
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    Storage() = default;
+
+    /**
+     *  @brief Allocates @param size elements, left uninitialized.
+     */
+    explicit Storage(size_t size) : _data(_allocate(size)), _size(size) {}
+
+    Storage(size_t size, const T &value) : Storage(size)
+    {
+        std::fill(begin(), end(), value);
+    }
+
+    Storage(const std::vector<T> &datas) : Storage(datas.size())
+    {
+        std::copy(datas.begin(), datas.end(), begin());
+    }
+
+    Storage(const Storage &oth) : Storage(oth._size)
+    {
+        std::copy(oth.begin(), oth.end(), begin());
+    }
+
+    Storage(Storage &&oth) noexcept
+        : _category(oth._category), _data(oth._data), _size(oth._size), _owned(oth._owned),
+          _readOnly(oth._readOnly), _owner(std::move(oth._owner))
+    {
+        oth._data = nullptr;
+        oth._size = 0;
+        oth._owned = true;
+        oth._readOnly = false;
+    }
+
+    ~Storage()
+    {
+        _release();
+    }
+
+    Storage &operator=(const Storage &oth)
+    {
+        if (this != &oth) {
+            _assign(oth.begin(), oth.end());
+        }
+        return *this;
+    }
+
+    Storage &operator=(Storage &&oth) noexcept
+    {
+        if (this != &oth) {
+            _release();
+            _category = oth._category;
+            _data = oth._data;
+            _size = oth._size;
+            _owned = oth._owned;
+            _readOnly = oth._readOnly;
+            _owner = std::move(oth._owner);
+            oth._data = nullptr;
+            oth._size = 0;
+            oth._owned = true;
+            oth._readOnly = false;
+        }
+        return *this;
+    }
+
+    Storage &operator=(const std::vector<T> &datas)
+    {
+        _assign(datas.data(), datas.data() + datas.size());
+        return *this;
+    }
+
+    /**
+     *  @brief Creates a non-owning Storage on @param size elements starting at @param data.
+     *
+     *  @param owner Optional handle kept alive as long as the view exists.
+     */
+    static Storage view(T *data, size_t size, std::shared_ptr<const void> owner = nullptr)
+    {
+        Storage storage;
+        storage._data = data;
+        storage._size = size;
+        storage._owned = false;
+        storage._owner = std::move(owner);
+        return storage;
+    }
+
+    /**
+     *  @brief Creates a view on memory that must not be written (eg. a file mapped PROT_READ).
+     *
+     *  Assigning to the Storage gives it its own buffer instead of writing through the view.
+     *
+     *  @param owner Optional handle kept alive as long as the view exists.
+     */
+    static Storage readOnlyView(const T *data, size_t size, std::shared_ptr<const void> owner = nullptr)
+    {
+        Storage storage = view(const_cast<T *>(data), size, std::move(owner));
+        storage._readOnly = true;
+        return storage;
+    }
+
+    bool isView() const
+    {
+        return !_owned;
+    }
+
+    memory::Category category() const
+    {
+        return _category;
+    }
+
+    /**
+     *  @brief Accounts the buffer in @param category from now on.
+     */
+    void setCategory(memory::Category category)
+    {
+        if (_owned && _data) {
+            memory::retag(_category, category, _size * sizeof(T));
+        }
+        _category = category;
+    }
+
+    /**
+     *  @brief Resizes the buffer, keeping the common prefix. New elements are uninitialized.
+     */
+    void resize(size_t size)
+    {
+        if (size == _size) {
+            return;
+        }
+        T *data = _allocate(size);
+        std::copy(begin(), begin() + std::min(size, _size), data);
+        _release();
+        _data = data;
+        _size = size;
+        _owned = true;
+    }
+
+    size_t size() const
+    {
+        return _size;
+    }
+
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    T *data()
+    {
+        return _data;
+    }
+
+    const T *data() const
+    {
+        return _data;
+    }
+
+    iterator begin()
+    {
+        return _data;
+    }
+
+    iterator end()
+    {
+        return _data + _size;
+    }
+
+    const_iterator begin() const
+    {
+        return _data;
+    }
+
+    const_iterator end() const
+    {
+        return _data + _size;
+    }
+
+    T &operator[](size_t idx)
+    {
+        return _data[idx];
+    }
+
+    const T &operator[](size_t idx) const
+    {
+        return _data[idx];
+    }
+
+    private:
+    T *_allocate(size_t size) const
+    {
+        if (size == 0) {
+            return nullptr;
+        }
+        profiler::Scope profile("Storage::allocate");
+        auto *data = static_cast<T *>(::operator new(size * sizeof(T), std::align_val_t{ALIGNMENT}));
+        memory::allocated(_category, size * sizeof(T));
+        return data;
+    }
+
+    void _release()
+    {
+        if (_owned && _data) {
+            memory::freed(_category, _size * sizeof(T));
+            ::operator delete(_data, std::align_val_t{ALIGNMENT});
+        }
+        _data = nullptr;
+        _size = 0;
+        _readOnly = false;
+        _owner.reset();
+    }
+
+    void _assign(const T *first, const T *last)
+    {
+        auto size = static_cast<size_t>(last - first);
+        if (size != _size || _readOnly) {
+            _release();
+            _data = _allocate(size);
+            _size = size;
+            _owned = true;
+        }
+        std::copy(first, last, _data);
+    }
+
+    memory::Category _category{memory::currentCategory()}; /** Declared first: _allocate() reads it */
+    T *_data{nullptr};
+    size_t _size{0};
+    bool _owned{true};
+    bool _readOnly{false}; /** View on memory that must not be written */
+    std::shared_ptr<const void> _owner; /** Keeps viewed memory alive */
+};
+
+} // namespace lava
@@ -7,6 +7,7 @@
 
 #include "Tensor.hpp"
 #include <memory>
+#include "Profiler/Profiler.hpp"
 #include "Tensor/TensorArray.hpp"
 #include "Tensor/autograd/AccumulateBackward.hpp"
 #include "Tensor/autograd/AddBackward.hpp"
@@ -18,7 +19,7 @@
 #include "Tensor/autograd/SumBackward.hpp"
 
 template <typename T>
-lava::Tensor<T>::Tensor(std::initializer_list<int> shape) : _tensor(shape), _grad(shape)
+lava::Tensor<T>::Tensor(std::initializer_list<int> shape) : _tensor(shape), _grad(gradFor(_tensor, false))
 {
 }
 
@@ -29,7 +30,17 @@ lava::Tensor<T>::Tensor(const Tensor<T> &tensor) : _tensor(tensor._tensor), _gra
 
 template <typename T>
 lava::Tensor<T>::Tensor(const TensorArray<T> &data, bool requiresGrad)
-    : _tensor(std::move(data)), _grad(data.shape(), data.strides()), _requiresGrad(requiresGrad)
+    : _tensor(data), _grad(gradFor(data, requiresGrad)), _requiresGrad(requiresGrad)
+{
+    if (requiresGrad) {
+        _gradNode = std::make_shared<AccumulateBackward<T>>(*this);
+        zeroGrad();
+    }
+}
+
+template <typename T>
+lava::Tensor<T>::Tensor(TensorArray<T> &&data, bool requiresGrad)
+    : _tensor(std::move(data)), _grad(gradFor(_tensor, requiresGrad)), _requiresGrad(requiresGrad)
 {
     if (requiresGrad) {
         _gradNode = std::make_shared<AccumulateBackward<T>>(*this);
@@ -39,7 +50,7 @@ lava::Tensor<T>::Tensor(const TensorArray<T> &data, bool requiresGrad)
 
 template <typename T>
 lava::Tensor<T>::Tensor(const TensorArray<T> &data, std::shared_ptr<GradNode<T>> gradNode, bool requiresGrad)
-    : _tensor(std::move(data)), _grad(data.shape(), data.strides()), _requiresGrad(requiresGrad), _gradNode(gradNode)
+    : _tensor(std::move(data)), _grad(gradFor(data, true)), _requiresGrad(requiresGrad), _gradNode(gradNode)
 {
     if (requiresGrad) {
         zeroGrad();
@@ -55,6 +66,7 @@ size_t lava::Tensor<T>::argmax()
 template <typename T>
 lava::Tensor<T> lava::Tensor<T>::matmul(Tensor &oth)
 {
+    lava::profiler::Scope profile("Tensor::matmul");
     TensorArray<T> result = _tensor.matmul(oth._tensor);
 
     if (!_requiresGrad && !oth._requiresGrad) {
@@ -72,7 +84,7 @@ lava::Tensor<T> lava::Tensor<T>::matmul(Tensor &oth)
         oth.tensor().unsqueezed(1); // Shape (Nx1)
     }
 
-    auto gradNode = std::make_shared<MMBackward<T>>(*this, oth);
+    auto gradNode = lava::makeGradNode<MMBackward<T>>(*this, oth);
 
     if (isUnsqueezedThis) {
         _tensor.removeDim();
@@ -88,14 +100,15 @@ lava::Tensor<T> lava::Tensor<T>::matmul(Tensor &oth)
 template <typename T>
 lava::Tensor<T> lava::Tensor<T>::sum()
 {
+    lava::profiler::Scope profile("Tensor::sum");
     T sumVal{0};
 
     for (const auto &val: _tensor.datas()) {
         sumVal += val;
     }
-    TensorArray<T> arr{1};
+    TensorArray<T> arr({1}, TensorArray<T>::InitType::UNINITIALIZED);
     arr[0] = sumVal;
-    auto gradNode = std::make_shared<SumBackward<T>>(*this);
+    auto gradNode = lava::makeGradNode<SumBackward<T>>(*this);
     
     return createWithGrad(arr, gradNode);
 }
@@ -121,13 +134,14 @@ lava::Tensor<T> &lava::Tensor<T>::operator=(lava::Tensor<T> &&oth) noexcept
 template <typename T>
 lava::Tensor<T> lava::Tensor<T>::Tensor::operator+(Tensor &oth)
 {
+    lava::profiler::Scope profile("Tensor::add");
     TensorArray<T> result = _tensor + oth._tensor;
 
     if (!_requiresGrad && !oth._requiresGrad) {
         return Tensor(result, false);
     }
 
-    auto gradNode = std::make_shared<AddBackward<T>>(*this, oth);
+    auto gradNode = lava::makeGradNode<AddBackward<T>>(*this, oth);
 
     return createWithGrad(result, gradNode);
 }
@@ -135,13 +149,14 @@ lava::Tensor<T> lava::Tensor<T>::Tensor::operator+(Tensor &oth)
 template <typename T>
 lava::Tensor<T> lava::Tensor<T>::operator-(Tensor &oth)
 {
+    lava::profiler::Scope profile("Tensor::sub");
     TensorArray<T> result = _tensor - oth._tensor;
 
     if (!_requiresGrad && !oth._requiresGrad) {
         return Tensor(result, false);
     }
 
-    auto gradNode = std::make_shared<SubBackward<T>>(*this, oth);
+    auto gradNode = lava::makeGradNode<SubBackward<T>>(*this, oth);
 
     return createWithGrad(result, gradNode);
 }
@@ -149,12 +164,13 @@ lava::Tensor<T> lava::Tensor<T>::operator-(Tensor &oth)
 template <typename T>
 lava::Tensor<T> lava::Tensor<T>::operator*(Tensor &oth)
 {
+    lava::profiler::Scope profile("Tensor::mul");
     TensorArray<T> result = _tensor * oth._tensor;
 
     if (!_requiresGrad && !oth._requiresGrad) {
         return Tensor(result, false);
     }
-    auto gradNode = std::make_shared<MulBackward<T>>(*this, oth);
+    auto gradNode = lava::makeGradNode<MulBackward<T>>(*this, oth);
 
     return createWithGrad(result, gradNode);
 }
@@ -162,12 +178,13 @@ lava::Tensor<T> lava::Tensor<T>::operator*(Tensor &oth)
 template <typename T>
 lava::Tensor<T> lava::Tensor<T>::operator/(Tensor &oth) // Does not work correctly on gradient
 {
+    lava::profiler::Scope profile("Tensor::div");
     TensorArray<T> result = _tensor / oth._tensor;
 
     if (!_requiresGrad && !oth._requiresGrad) {
         return Tensor(result, false);
     }
-    auto gradNode = std::make_shared<DivBackward<T>>(*this, oth);
+    auto gradNode = lava::makeGradNode<DivBackward<T>>(*this, oth);
 
     return createWithGrad(result, gradNode);
 }
@@ -175,12 +192,13 @@ lava::Tensor<T> lava::Tensor<T>::operator/(Tensor &oth) // Does not work correct
 template <typename T>
 lava::Tensor<T> lava::Tensor<T>::operator+(T k)
 {
+    lava::profiler::Scope profile("Tensor::add_scalar");
     TensorArray<T> result = _tensor + k;
 
     if (!_requiresGrad) {
         return Tensor(result, false);
     }
-    auto gradNode = std::make_shared<AddBackward<T>>(*this);
+    auto gradNode = lava::makeGradNode<AddBackward<T>>(*this);
 
     return createWithGrad(result, gradNode);
 }
@@ -188,12 +206,13 @@ lava::Tensor<T> lava::Tensor<T>::operator+(T k)
 template <typename T>
 lava::Tensor<T> lava::Tensor<T>::operator-(T k)
 {
+    lava::profiler::Scope profile("Tensor::sub_scalar");
     TensorArray<T> result = _tensor - k;
 
     if (!_requiresGrad) {
         return Tensor(result, false);
     }
-    auto gradNode = std::make_shared<SubBackward<T>>(*this);
+    auto gradNode = lava::makeGradNode<SubBackward<T>>(*this);
 
     return createWithGrad(result, gradNode);
 }
@@ -201,12 +220,13 @@ lava::Tensor<T> lava::Tensor<T>::operator-(T k)
 template <typename T>
 lava::Tensor<T> lava::Tensor<T>::operator*(T k)
 {
+    lava::profiler::Scope profile("Tensor::mul_scalar");
     TensorArray<T> result = _tensor * k;
 
     if (!_requiresGrad) {
         return Tensor(result, false);
     }
-    auto gradNode = std::make_shared<MulBackward<T>>(*this, k);
+    auto gradNode = lava::makeGradNode<MulBackward<T>>(*this, k);
 
     return createWithGrad(result, gradNode);
 }
@@ -214,12 +234,13 @@ lava::Tensor<T> lava::Tensor<T>::operator*(T k)
 template <typename T>
 lava::Tensor<T> lava::Tensor<T>::operator/(T k)
 {
+    lava::profiler::Scope profile("Tensor::div_scalar");
     TensorArray<T> result = _tensor / k;
 
     if (!_requiresGrad) {
         return Tensor(result, false);
     }
-    auto gradNode = std::make_shared<DivBackward<T>>(*this, k);
+    auto gradNode = lava::makeGradNode<DivBackward<T>>(*this, k);
 
     return createWithGrad(result, gradNode);
 }
@@ -251,6 +272,7 @@ T &lava::Tensor<T>::operator[](size_t idx)
 template <typename T>
 void lava::Tensor<T>::backward() // Modify this
 {
+    lava::profiler::Scope profile("Tensor::backward");
     // Check of dim 1
     // this->_gradNode->backward(); // From one dim to the input tensor
 
@@ -275,3 +297,14 @@ lava::Tensor<T> lava::Tensor<T>::createWithGrad(
 {
     return Tensor{data, gradNode, true};
 }
+
+template <typename T>
+lava::TensorArray<T> lava::Tensor<T>::gradFor(const TensorArray<T> &data, bool requiresGrad)
+{
+    // Tensors that never receive a gradient do not pay for a gradient buffer
+    if (!requiresGrad) {
+        return TensorArray<T>({0}, TensorArray<T>::InitType::ZERO);
+    }
+    memory::Scope scope(memory::Category::GRADS);
+    return TensorArray<T>(data.shape(), data.strides());
+}
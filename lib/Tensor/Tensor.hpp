@@ -24,6 +24,7 @@ class Tensor {
     Tensor(std::initializer_list<int> shape);
     Tensor(const Tensor &tensor);
     Tensor(const TensorArray<T> &data, bool requiresGrad = false);
+    Tensor(TensorArray<T> &&data, bool requiresGrad = false);
     Tensor(const TensorArray<T> &data, std::shared_ptr<GradNode<T>> gradNode, bool requiresGrad = false);
 
     void backward();
@@ -37,6 +38,9 @@ class Tensor {
     void setRequiresGrad(bool requiresGrad)
     {
         _requiresGrad = requiresGrad;
+        if (_requiresGrad && _grad.datas().size() != _tensor.datas().size()) {
+            _grad = TensorArray<T>(_tensor.shape(), _tensor.strides());
+        }
     }
 
     void dispRaw()
@@ -97,12 +101,12 @@ class Tensor {
         return _tensor.shape();
     }
 
-    std::vector<T> &datas()
+    Storage<T> &datas()
     {
         return _tensor.datas();
     }
 
-    const std::vector<T> &datas() const
+    const Storage<T> &datas() const
     {
         return _tensor.datas();
     }
@@ -131,6 +135,7 @@ class Tensor {
     std::shared_ptr<GradNode<T>> _gradNode = nullptr; // Default when having a gradient is AccumulateGrad
 
     static Tensor createWithGrad(TensorArray<T> data, std::shared_ptr<GradNode<T>> gradNode);
+    static TensorArray<T> gradFor(const TensorArray<T> &data, bool requiresGrad);
 };
 
 } // namespace lava
@@ -6,6 +6,7 @@
 */
 
 #include "TensorArray.hpp"
+#include "Profiler/Profiler.hpp"
 
 #include <algorithm>
 #include <cmath>
@@ -36,7 +37,7 @@ lava::TensorArray<T>::TensorArray(std::initializer_list<int> shape, InitType typ
     for (const auto &s : _shape) {
         size *= s;
     }
-    _datas.reserve(size);
+    _datas = Storage<T>(size);
 
     for (size_t k = 0; k < _shape.size(); k++) {
         _strides.push_back(getStride(k, _shape));
@@ -50,7 +51,7 @@ lava::TensorArray<T>::TensorArray(std::initializer_list<int> shape, InitType typ
             T stddev = static_cast<T>(std::sqrt(2.0 / _shape[0]));
             std::normal_distribution<T> dist(0.0, stddev);
             for (size_t i = 0; i < size; i++) {
-                _datas.push_back(dist(gen));
+                _datas[i] = dist(gen);
             }
         } else {
             // For integer types, use a uniform distribution
@@ -58,23 +59,19 @@ lava::TensorArray<T>::TensorArray(std::initializer_list<int> shape, InitType typ
             int range = static_cast<int>(std::sqrt(6.0 / _shape[0]));
             std::uniform_int_distribution<int> dist(-range, range);
             for (size_t i = 0; i < size; i++) {
-                _datas.push_back(static_cast<T>(dist(gen)));
+                _datas[i] = static_cast<T>(dist(gen));
             }
         }
     }
     if (type == InitType::ZERO) {
-        for (size_t i = 0; i < size; i++) {
-            _datas.push_back(T{0});
-        }
+        std::fill(_datas.begin(), _datas.end(), T{0});
     }
     if (type == InitType::ONES) {
-        for (size_t i = 0; i < size; i++) {
-            _datas.push_back(1);
-        }
+        std::fill(_datas.begin(), _datas.end(), T{1});
     }
     if (type == InitType::RANGE) {
         for (size_t i = 0; i < size; i++) {
-            _datas.push_back(i);
+            _datas[i] = static_cast<T>(i);
         }
     }
 }
@@ -98,7 +95,7 @@ lava::TensorArray<T>::TensorArray(const std::vector<T> &datas)
 }
 
 template <typename T>
-lava::TensorArray<T>::TensorArray(const std::vector<int> &shape, const std::vector<int> &strides)
+lava::TensorArray<T>::TensorArray(const std::vector<int> &shape, const std::vector<int> &strides, InitType type)
     : _shape(shape), _strides(strides), _datas()
 {
     size_t size = 1;
@@ -106,55 +103,36 @@ lava::TensorArray<T>::TensorArray(const std::vector<int> &shape, const std::vect
     for (const auto &s : _shape) {
         size *= s;
     }
-    for (size_t i = 0; i < size; i++) {
-        _datas.push_back(T{0});
-    }
-}
-
-template <typename T>
-lava::TensorArray<T> &lava::TensorArray<T>::_inPlaceTensorOperation(
-    const TensorArray &oth,
-    std::function<T(const T &, const T &)> func
-)
-{
-    for (size_t i = 0; i < _datas.size(); i++) {
-        this->operator[](i) = func(this->operator[](i), oth[i]);
+    switch (type) {
+        case InitType::UNINITIALIZED:
+            _datas = Storage<T>(size);
+            break;
+        case InitType::ONES:
+            _datas = Storage<T>(size, T{1});
+            break;
+        case InitType::ZERO:
+            _datas = Storage<T>(size, T{0});
+            break;
+        default:
+            throw std::logic_error("[ERR] Unsupported initialization type for a strided tensor.");
     }
-    return *this;
 }
 
 template <typename T>
-lava::TensorArray<T> lava::TensorArray<T>::_tensorOperation(
-    const TensorArray &oth,
-    std::function<T(const T &, const T &)> func
-) const
+lava::TensorArray<T>::TensorArray(const std::vector<int> &shape, Storage<T> &&datas)
+    : _shape(shape), _datas(std::move(datas))
 {
-    TensorArray newTensor(_shape, _strides);
+    size_t size = 1;
 
-    for (size_t i = 0; i < _datas.size(); i++) {
-        newTensor[i] = func(this->operator[](i), oth[i]);
+    for (const auto &s : _shape) {
+        size *= s;
     }
-    return newTensor;
-}
-
-template <typename T>
-lava::TensorArray<T> &lava::TensorArray<T>::_inPlaceScalarOperation(T k, std::function<T(const T &, const T &)> func)
-{
-    for (size_t i = 0; i < _datas.size(); i++) {
-        this->operator[](i) = func(this->operator[](i), k);
+    if (size != _datas.size()) {
+        throw std::logic_error("[ERR] Storage size does not match the tensor shape.");
     }
-    return *this;
-}
-
-template <typename T>
-lava::TensorArray<T> lava::TensorArray<T>::_scalarOperation(T k, std::function<T(const T &, const T &)> func) const
-{
-    TensorArray<T> newTensor(_shape, _strides);
-
-    for (size_t i = 0; i < _datas.size(); i++) {
-        newTensor[i] = func(this->operator[](i), k);
+    for (size_t k = 0; k < _shape.size(); k++) {
+        _strides.push_back(getStride(k, _shape));
     }
-    return newTensor;
 }
 
 template <typename T>
@@ -194,6 +172,7 @@ lava::TensorArray<T> &lava::TensorArray<T>::removeDim(size_t dim)
 template <typename T>
 lava::TensorArray<T> lava::TensorArray<T>::matmul(TensorArray &oth) // only 2 DIM Tensors are supported
 {
+    lava::profiler::Scope profile("TensorArray::matmul");
     bool isUnsqueezedThis = false;
     bool isUnsqueezedOth = false;
     if (_shape.size() == 1) {
@@ -247,16 +226,15 @@ lava::TensorArray<T> lava::TensorArray<T>::transpose() const
         throw std::logic_error("[ERR] Only 2 Dimensional Tensors are supported for transpose");
     }
 
-    std::vector<int> newShape(_shape.size());
-    std::vector<int> newStrides(_strides.size());
-    std::reverse_copy(_shape.begin(), _shape.end(), newShape.begin());
-    std::reverse_copy(_strides.begin(), _strides.end(), newStrides.begin());
+    // The copy is contiguous (row-major), unlike transposed() which only swaps the strides
+    std::vector<int> newShape = {_shape[1], _shape[0]};
+    std::vector<int> newStrides = {_shape[0], 1};
 
-    TensorArray<T> result(newShape, newStrides);
+    TensorArray<T> result(newShape, newStrides, InitType::UNINITIALIZED);
 
     for (int i = 0; i < _shape[0]; i++) {
         for (int j = 0; j < _shape[1]; j++) {
-            result({i, j}) = this->operator()({i, j});
+            result({j, i}) = this->operator()({i, j});
         }
     }
     return result;
@@ -10,10 +10,11 @@
 #include <cstddef>
 #include <cstdio>
 #include <cstdlib>
-#include <functional>
 #include <stdexcept>
 #include <vector>
 #include <initializer_list>
+#include "Tensor/Expression.hpp"
+#include "Tensor/Storage.hpp"
 
 namespace lava {
 
@@ -27,11 +28,14 @@ namespace lava {
 template <typename T>
 class TensorArray {
     public:
+    using value_type = T;
+
     enum class InitType {
         ZERO,
         ONES,
         RANDOM,
-        RANGE
+        RANGE,
+        UNINITIALIZED
     };
 
     /**
@@ -47,6 +51,8 @@ class TensorArray {
      *
      *  NOTE: This constructor inits the strides with the shape and
      *       it inits the underlying datas randomly.
+     *       Use `InitType::UNINITIALIZED` when every element is about to be overwritten
+     *       (eg. weights loaded from a file), it only allocates the datas.
      */
     TensorArray(std::initializer_list<int> shape, InitType type = InitType::RANDOM);
 
@@ -55,11 +61,12 @@ class TensorArray {
      *
      *  @param shape Shape given to the new Tensor created
      *  @param strides Strides given to the new Tensor created
+     *  @param type Initialization type, only `ZERO`, `ONES` and `UNINITIALIZED` are supported
      *
-     *  NOTE: This constructor inits the strides with the shape and
-     *        it inits the underlying datas with default value of @tparam T (eg. `0` for `int`).
+     *  NOTE: By default this constructor inits the underlying datas with default value of @tparam T
+     *        (eg. `0` for `int`).
      */
-    TensorArray(const std::vector<int> &shape, const std::vector<int> &strides);
+    TensorArray(const std::vector<int> &shape, const std::vector<int> &strides, InitType type = InitType::ZERO);
 
     /**
      *  @brief Copy constructor of the TensorArray class
@@ -88,6 +95,31 @@ class TensorArray {
      */
     TensorArray(const std::vector<T> &datas);
 
+    /**
+     *  @brief Constructor of TensorArray on an already filled storage.
+     *
+     *  @param shape Shape given to the new Tensor created
+     *  @param datas Storage moved in the new Tensor, it can be a view on memory owned elsewhere
+     *
+     *  NOTE: The strides are computed from the shape (row-major).
+     */
+    TensorArray(const std::vector<int> &shape, Storage<T> &&datas);
+
+    /**
+     *  @brief Constructor of TensorArray evaluating an arithmetic expression, in a single loop.
+     *
+     *  @param expression Result of the arithmetic operators on tensors (eg. `a * b + c`)
+     *
+     *  NOTE: The shape and the strides are the ones of the leftmost tensor of the expression.
+     */
+    template <typename E>
+        requires std::derived_from<E, expr::Node>
+    TensorArray(const E &expression)
+        : TensorArray(expression.source().shape(), expression.source().strides(), InitType::UNINITIALIZED)
+    {
+        expr::evaluate(_datas.data(), _datas.size(), expression);
+    }
+
     /**
      *  @brief Default destructor of the TensorArray class
      */
@@ -127,104 +159,55 @@ class TensorArray {
 
     TensorArray &operator=(TensorArray<T> &&oth) noexcept;
 
-    TensorArray operator+(const TensorArray &oth) const
-    {
-        return _tensorOperation(oth, std::plus<T>());
-    }
-
-    TensorArray operator-(const TensorArray &oth) const
-    {
-        return _tensorOperation(oth, std::minus<T>());
-    }
-
-    TensorArray operator*(const TensorArray &oth) const
-    {
-        return _tensorOperation(oth, std::multiplies<T>());
-    }
-
-    TensorArray operator/(const TensorArray &oth) const
-    {
-        return _tensorOperation(oth, [](const T &a, const T &b) {
-            if (b == 0) {
-                throw std::logic_error("[ERR] Zero division Error while doing a div operation.");
-            }
-            return std::divides<T>()(a, b);
-        });
-    }
-
-    TensorArray &operator+=(TensorArray &oth)
-    {
-        return _inPlaceTensorOperation(oth, std::plus<T>());
-    }
-
-    TensorArray &operator-=(TensorArray &oth)
-    {
-        return _inPlaceTensorOperation(oth, std::minus<T>());
-    }
-
-    TensorArray &operator*=(TensorArray &oth)
-    {
-        return _inPlaceTensorOperation(oth, std::multiplies<T>());
-    }
-
-    TensorArray &operator/=(TensorArray &oth)
-    {
-        return _inPlaceTensorOperation(oth, [](const T &a, const T &b) {
-            if (b == 0) {
-                throw std::logic_error("[ERR] Zero division Error while doing a div operation.");
-            }
-            return std::divides<T>()(a, b);
-        });
-    }
-
-    TensorArray operator+(T k) const
+    /**
+     *  @brief In-place arithmetic, element by element with @param oth (a tensor or an expression) or
+     *         with the scalar @param k, in a single loop over the datas of `this`.
+     *
+     *  NOTE: The binary operators (`a + b`, `a * 2`...) are in Tensor/Expression.hpp, they build
+     *        expressions evaluated when they become a TensorArray.
+     */
+    template <expr::Operand E>
+    TensorArray &operator+=(const E &oth)
     {
-        return _scalarOperation(k, std::plus<T>());
+        return _assign(*this + oth);
     }
 
-    TensorArray operator-(T k) const
+    template <expr::Operand E>
+    TensorArray &operator-=(const E &oth)
     {
-        return _scalarOperation(k, std::minus<T>());
+        return _assign(*this - oth);
     }
 
-    TensorArray operator*(T k) const
+    template <expr::Operand E>
+    TensorArray &operator*=(const E &oth)
     {
-        return _scalarOperation(k, std::multiplies<T>());
+        return _assign(*this * oth);
     }
 
-    TensorArray operator/(T k) const
+    template <expr::Operand E>
+    TensorArray &operator/=(const E &oth)
     {
-        return _scalarOperation(k, [](const T &a, const T &b) {
-            if (b == 0) {
-                throw std::logic_error("[ERR] Zero division Error while doing a div operation.");
-            }
-            return std::divides<T>()(a, b);
-        });
+        return _assign(*this / oth);
     }
 
     TensorArray &operator+=(T k)
     {
-        return _inPlaceScalarOperation(k, std::plus<T>());
+        return _assign(*this + k);
     }
 
     TensorArray &operator-=(T k)
     {
-        return _inPlaceScalarOperation(k, std::minus<T>());
+        return _assign(*this - k);
     }
 
     TensorArray &operator*=(T k)
     {
-        return _inPlaceScalarOperation(k, std::multiplies<T>());
+        return _assign(*this * k);
     }
 
     TensorArray &operator/=(T k)
     {
-        return _inPlaceScalarOperation(k, [](const T &a, const T &b) {
-            if (b == 0) {
-                throw std::logic_error("[ERR] Zero division Error while doing a div operation.");
-            }
-            return std::divides<T>()(a, b);
-        });
+        return _assign(*this / k);
     }
 
     T operator()(std::initializer_list<int> indexes) const;
@@ -272,12 +255,12 @@ class TensorArray {
         return _strides;
     }
 
-    std::vector<T> &datas()
+    Storage<T> &datas()
     {
         return _datas;
     }
 
-    const std::vector<T> &datas() const
+    const Storage<T> &datas() const
     {
         return _datas;
     }
@@ -286,52 +269,21 @@ class TensorArray {
     // TODO: Checks of shape to be done !
 
     /**
-     *  @brief Do an in-place operation specified by @param func that takes another tensor @param oth on the current
-     * tensor. This operation takes the elements of `this` and @param oth one by one and perform the operation.
-     *
-     *  @param oth The other tensor that will be used to modify the current one.
-     *  @param func Operation take 2 values and return a single result that modify the current Tensor.
-     *
-     *  @return Reference to the current Tensor that has the result of the operations.
-     */
-    TensorArray &_inPlaceTensorOperation(const TensorArray &oth, std::function<T(const T &, const T &)> func);
-    /**
-     *  @brief Do an in-place operation specified by @param func that takes another tensor @param oth on the current
-     * tensor. This operation takes the elements of `this` and @param oth one by one and perform the operation to create
-     * a new Tensor
-     *
-     *  @param oth The other tensor that will be used to compute the new one
-     *  @param func Operation take 2 values and return a single result that is added to the Tensor returned.
-     *
-     *  @return A new tensor which has the result of the operation done.
-     */
-    TensorArray _tensorOperation(const TensorArray &oth, std::function<T(const T &, const T &)> func) const;
-    /**
-     *  @brief Do an in-place operation specified, by @param func , that takes a scalar @param oth , on the current
-     * tensor. This operation takes the elements of `this` one by one and perform an in-place operation with k.
-     *
-     *  @param k Scalar that will be used by @param func for the binary operation done on the current tensor.
-     *  @param func Operation take 2 values and return a single result that modify the current Tensor.
-     *
-     *  @return Reference to the current Tensor that has the result of the operations.
+     *  @brief Overwrites the datas of `this` with @param expression, which may read them.
      */
-    TensorArray &_inPlaceScalarOperation(T k, std::function<T(const T &, const T &)> func);
-    /**
-     *  @brief Do an in-place operation specified, by @param func , that takes a scalar @param oth , on the current
-     * tensor. This operation takes the elements of `this` one by one and perform an in-place operation with k.
-     *
-     *  @param k Scalar that will be used by @param func for the binary operation done on the new tensor.
-     *  @param func Operation take 2 values and return a single result that modify the new Tensor.
-     *
-     *  @return A new Tensor that has the result of the operations.
-     */
-    TensorArray _scalarOperation(T k, std::function<T(const T &, const T &)> func) const;
+    template <typename E>
+    TensorArray &_assign(const E &expression)
+    {
+        expr::evaluate(_datas.data(), _datas.size(), expression);
+        return *this;
+    }
+
     static size_t getStride(size_t k, const std::vector<int> &shape);
 
     std::vector<int> _shape;   /** Shape of the Tensor */
     std::vector<int> _strides; /** Stride of the Tensor */
 
-    std::vector<T> _datas; /** Underlying datas of the Tensor */
+    Storage<T> _datas; /** Underlying datas of the Tensor */
 };
 
 } // namespace lava
@@ -8,9 +8,11 @@
 #pragma once
 
 #include <iostream>
+#include "Profiler/Profiler.hpp"
 #include "Tensor/Tensor.hpp"
 #include "Tensor/TensorArray.hpp"
 #include "Tensor/autograd/GradNode.hpp"
+#include "Tensor/autograd/GradientSink.hpp"
 
 namespace lava {
 
@@ -27,6 +29,15 @@ public:
 
     void backward(TensorArray<T> grad) override
     {
+        profiler::Scope profile("AccumulateBackward");
+        auto &accumulated = _tensor.grad().datas();
+        if (T *local = GradientSink<T>::redirect(accumulated.data())) {
+            const auto &values = grad.datas();
+            for (size_t i = 0; i < accumulated.size(); i++) {
+                local[i] += values[i];
+            }
+            return;
+        }
         _tensor.grad() += grad;
         _tensor.grad().dispRaw();
     }
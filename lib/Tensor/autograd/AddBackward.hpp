@@ -8,6 +8,7 @@
 #pragma once
 
 #include <iostream>
+#include "Profiler/Profiler.hpp"
 #include "Tensor/Tensor.hpp"
 #include "Tensor/TensorArray.hpp"
 #include "Tensor/autograd/GradNode.hpp"
@@ -41,6 +42,7 @@ public:
 
     void backward(TensorArray<T> grad) override
     {
+        profiler::Scope profile("AddBackward");
         if (this->_nextGrads[0]) {
             this->_nextGrads[0]->backward(grad * _onesArr);
         }
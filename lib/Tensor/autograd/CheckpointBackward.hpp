@@ -0,0 +1,109 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** CheckpointBackward
+*/
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+#include "Profiler/Profiler.hpp"
+#include "Tensor/Tensor.hpp"
+#include "Tensor/TensorArray.hpp"
+#include "Tensor/autograd/GradNode.hpp"
+
+namespace lava {
+
+/**
+ *  @brief Leaf of a recomputed segment graph: keeps the gradient of the segment input instead of
+ *         accumulating it in a tensor.
+ */
+template <typename T>
+class CheckpointInputGrad : public GradNode<T> {
+public:
+    CheckpointInputGrad() = default;
+    ~CheckpointInputGrad() override = default;
+
+    void backward(TensorArray<T> grad) override
+    {
+        if (_grad) {
+            *_grad += grad;
+        } else {
+            _grad = std::move(grad);
+        }
+    }
+
+    void backward() override
+    {
+        // This should never be called without a gradient
+    }
+
+    std::optional<TensorArray<T>> &grad() { return _grad; }
+
+private:
+    std::optional<TensorArray<T>> _grad;
+};
+
+/**
+ *  @brief Backward of a checkpointed segment of layers (activation checkpointing).
+ *
+ *  Only the segment input is saved: the graph built by the forward pass is dropped, and the backward pass
+ *  runs the segment again to rebuild it before back-propagating through it. The recomputed graph is freed
+ *  before the gradient reaches the previous segment, so one segment graph is alive at a time.
+ *
+ *  NOTE: The segment must be deterministic, and its parameters must not change between the forward and the
+ *        backward pass.
+ */
+template <typename T>
+class CheckpointBackward : public GradNode<T> {
+public:
+    using Segment = std::function<Tensor<T>(Tensor<T> &)>;
+
+    CheckpointBackward(Tensor<T> &input, const Tensor<T> &output, Segment segment):
+        lava::GradNode<T>(),
+        _input(input.tensor()),
+        _outputShape(output.shape()),
+        _segment(std::move(segment))
+    {
+        this->_nextGrads.push_back(input.gradNode());
+    }
+
+    ~CheckpointBackward() override = default;
+
+    void backward(TensorArray<T> grad) override
+    {
+        profiler::Scope profile("CheckpointBackward");
+        auto capture = this->_nextGrads[0] ? std::make_shared<CheckpointInputGrad<T>>() : nullptr;
+        {
+            Tensor<T> input = capture ? Tensor<T>(_input, capture, true) : Tensor<T>(_input, false);
+            Tensor<T> output = _segment(input);
+            if (output.gradNode()) {
+                output.gradNode()->backward(std::move(grad));
+            }
+        }
+        if (capture && capture->grad()) {
+            this->_nextGrads[0]->backward(std::move(*capture->grad()));
+        }
+    }
+
+    void backward() override
+    {
+        // This should never be called without a gradient
+        size_t size = 1;
+        for (int dim : _outputShape) {
+            size *= dim;
+        }
+        backward(TensorArray<T>(_outputShape, Storage<T>(size, T(1))));
+    }
+
+private:
+    TensorArray<T> _input;
+    std::vector<int> _outputShape;
+    Segment _segment;
+};
+
+}
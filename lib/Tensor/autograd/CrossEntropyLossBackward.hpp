@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include "Profiler/Profiler.hpp"
 #include "Tensor/Tensor.hpp"
 #include "Tensor/TensorArray.hpp"
 #include "Tensor/autograd/GradNode.hpp"
@@ -25,6 +26,7 @@ class CrossEntropyLossBackward : public GradNode<T> {
 
     void backward(TensorArray<T> grad) override
     {
+        profiler::Scope profile("CrossEntropyLossBackward");
         _res[_targetIndex] -= 1;
         if (this->_nextGrads[0]) {
             this->_nextGrads[0]->backward(_res * grad);
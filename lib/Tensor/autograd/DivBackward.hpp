@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include "Profiler/Profiler.hpp"
 #include "Tensor/Tensor.hpp"
 #include "Tensor/TensorArray.hpp"
 #include "Tensor/autograd/GradNode.hpp"
@@ -28,7 +29,7 @@ public:
     DivBackward(Tensor<T> &tensorA, T k):
         lava::GradNode<T>(),
         _tensorACpy(tensorA.tensor()),
-        _tensorBCpy(tensorA.tensor().shape(), tensorA.tensor().strides())
+        _tensorBCpy(tensorA.tensor().shape(), tensorA.tensor().strides(), TensorArray<T>::InitType::UNINITIALIZED)
     {
         this->_nextGrads.push_back(tensorA.gradNode());
         this->_nextGrads.push_back(nullptr);
@@ -40,6 +41,7 @@ public:
 
     void backward(TensorArray<T> grad) override
     {
+        profiler::Scope profile("DivBackward");
         if (this->_nextGrads[0]) {
             // this->_nextGrads[0]->backward(grad * (1 / _tensorBCpy)); // TODO Implement left operators
         }
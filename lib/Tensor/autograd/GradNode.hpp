@@ -9,7 +9,9 @@
 
 #include <iostream>
 #include <memory>
+#include <utility>
 #include <vector>
+#include "Tensor/Memory.hpp"
 #include "Tensor/TensorArray.hpp"
 
 namespace lava {
@@ -40,4 +42,15 @@ protected:
     std::vector<std::shared_ptr<GradNode<T>>> _nextGrads;
 };
 
-}
\ No newline at end of file
+/**
+ *  @brief Creates an autograd node, the tensors it saves for the backward pass are accounted as
+ *         memory::Category::SAVED.
+ */
+template <typename Node, typename... Args>
+std::shared_ptr<Node> makeGradNode(Args &&...args)
+{
+    memory::Scope scope(memory::Category::SAVED);
+    return std::make_shared<Node>(std::forward<Args>(args)...);
+}
+
+}
@@ -0,0 +1,66 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** GradientSink
+*/
+
+#pragma once
+
+#include <cstddef>
+
+namespace lava {
+
+/**
+ *  @tparam Type of the gradients.
+ *
+ *  @brief Redirects, on the calling thread, the gradients accumulated in a gradient arena to a private
+ *         buffer with the same layout.
+ *
+ *  While a sink is alive, AccumulateBackward adds the gradient of a tensor whose gradient storage lies in
+ *  [arena, arena + size) at the same offset of @param local instead. Each thread can then train on shared
+ *  weights with its own gradients (Hogwild! training).
+ *
+ *  NOTE: Sinks are scoped: destroying one restores the previous sink of the thread.
+ */
+template <typename T>
+class GradientSink {
+    public:
+    GradientSink(const T *arena, T *local, size_t size)
+        : _arena(arena), _local(local), _size(size), _previous(_current)
+    {
+        _current = this;
+    }
+
+    GradientSink(const GradientSink &) = delete;
+    GradientSink &operator=(const GradientSink &) = delete;
+
+    ~GradientSink()
+    {
+        _current = _previous;
+    }
+
+    /**
+     *  @return Where the gradient stored at @param grad must be accumulated on this thread,
+     *          or nullptr when it is not redirected.
+     */
+    static T *redirect(const T *grad)
+    {
+        const GradientSink *sink = _current;
+
+        if (!sink || grad < sink->_arena || grad >= sink->_arena + sink->_size) {
+            return nullptr;
+        }
+        return sink->_local + (grad - sink->_arena);
+    }
+
+    private:
+    const T *_arena;
+    T *_local;
+    size_t _size;
+    GradientSink *_previous;
+
+    static inline thread_local GradientSink *_current = nullptr;
+};
+
+} // namespace lava
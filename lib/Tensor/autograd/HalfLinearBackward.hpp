@@ -0,0 +1,128 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** HalfLinearBackward
+*/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "Profiler/Profiler.hpp"
+#include "Tensor/HalfKernels.hpp"
+#include "Tensor/Storage.hpp"
+#include "Tensor/Tensor.hpp"
+#include "Tensor/TensorArray.hpp"
+#include "Tensor/autograd/GradNode.hpp"
+
+namespace lava {
+
+/**
+ *  @brief Backward of a Linear layer computed in half precision: y = x * W + b.
+ *
+ *  The input is saved as half, and the incoming gradient is rounded to half before being used, like
+ *  a half gradient buffer. The products accumulate in float32 and the weights gradient is a float32
+ *  array, summed into the float32 master gradients.
+ *
+ *  NOTE: The half weights are the transposed (outFeatures, inFeatures) copy used by the forward pass.
+ */
+class HalfLinearBackward : public GradNode<float> {
+public:
+    HalfLinearBackward(
+        Tensor<float> &input,
+        Tensor<float> &weights,
+        Tensor<float> &biases,
+        std::shared_ptr<const Storage<uint16_t>> halfWeights,
+        kernels::HalfFormat format
+    ):
+        lava::GradNode<float>(),
+        _inputShape(input.shape()),
+        _input(input.datas().size()),
+        _halfWeights(std::move(halfWeights)),
+        _format(format),
+        _inFeatures(weights.shape()[0]),
+        _outFeatures(weights.shape()[1])
+    {
+        kernels::toHalf(_format, input.datas().data(), _input.data(), _input.size());
+        this->_nextGrads.push_back(input.gradNode());
+        this->_nextGrads.push_back(weights.gradNode());
+        this->_nextGrads.push_back(biases.gradNode());
+    }
+
+    ~HalfLinearBackward() override = default;
+
+    void backward(TensorArray<float> grad) override
+    {
+        profiler::Scope profile("HalfLinearBackward");
+        const size_t rows = _input.size() / _inFeatures;
+        auto &values = grad.datas();
+        Storage<uint16_t> halfGrad(values.size());
+        kernels::toHalf(_format, values.data(), halfGrad.data(), values.size());
+        kernels::fromHalf(_format, halfGrad.data(), values.data(), values.size());
+
+        // For x: grad_x = grad × W^T
+        if (this->_nextGrads[0]) {
+            TensorArray<float> gradInput(_inputShape, Storage<float>(_input.size()));
+            for (size_t r = 0; r < rows; r++) {
+                kernels::gemvHalfTransposed(
+                    _format,
+                    values.data() + r * _outFeatures,
+                    _halfWeights->data(),
+                    _outFeatures,
+                    _inFeatures,
+                    gradInput.datas().data() + r * _inFeatures
+                );
+            }
+            this->_nextGrads[0]->backward(std::move(gradInput));
+        }
+
+        // For W: grad_W = x^T × grad, one outer product per row
+        if (this->_nextGrads[1]) {
+            std::vector<int> shape = {static_cast<int>(_inFeatures), static_cast<int>(_outFeatures)};
+            TensorArray<float> gradWeights(shape, Storage<float>(_inFeatures * _outFeatures, 0.0f));
+            float *out = gradWeights.datas().data();
+            std::vector<float> input(_inFeatures);
+            for (size_t r = 0; r < rows; r++) {
+                kernels::fromHalf(_format, _input.data() + r * _inFeatures, input.data(), _inFeatures);
+                const float *g = values.data() + r * _outFeatures;
+                for (size_t k = 0; k < _inFeatures; k++) {
+                    float *row = out + k * _outFeatures;
+                    for (size_t j = 0; j < _outFeatures; j++) {
+                        row[j] += input[k] * g[j];
+                    }
+                }
+            }
+            this->_nextGrads[1]->backward(std::move(gradWeights));
+        }
+
+        // For b: the gradient summed over the rows
+        if (this->_nextGrads[2]) {
+            std::vector<int> shape = {static_cast<int>(_outFeatures)};
+            TensorArray<float> gradBiases(shape, Storage<float>(_outFeatures, 0.0f));
+            for (size_t r = 0; r < rows; r++) {
+                for (size_t j = 0; j < _outFeatures; j++) {
+                    gradBiases.datas()[j] += values[r * _outFeatures + j];
+                }
+            }
+            this->_nextGrads[2]->backward(std::move(gradBiases));
+        }
+    }
+
+    void backward() override
+    {
+        // This should never be called without a gradient
+        std::vector<int> shape = {static_cast<int>(_input.size() / _inFeatures), static_cast<int>(_outFeatures)};
+        backward(TensorArray<float>(shape, Storage<float>(_input.size() / _inFeatures * _outFeatures, 1.0f)));
+    }
+
+private:
+    std::vector<int> _inputShape;
+    Storage<uint16_t> _input;
+    std::shared_ptr<const Storage<uint16_t>> _halfWeights;
+    kernels::HalfFormat _format;
+    size_t _inFeatures;
+    size_t _outFeatures;
+};
+
+}
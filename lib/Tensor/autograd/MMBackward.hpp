@@ -8,6 +8,7 @@
 #pragma once
 
 #include <cstdio>
+#include "Profiler/Profiler.hpp"
 #include "Tensor/Tensor.hpp"
 #include "Tensor/TensorArray.hpp"
 #include "Tensor/autograd/GradNode.hpp"
@@ -30,6 +31,7 @@ public:
 
     void backward(TensorArray<T> grad) override
     {
+        profiler::Scope profile("MMBackward");
         // For A: grad_A = grad_C × B^T
         if (this->_nextGrads[0]) {
             _tensorBCpy.transposed();
@@ -49,8 +51,7 @@ public:
     void backward() override
     {
         // This should never be called without a gradient
-        TensorArray<T> ones(_tensorACpy.shape(), _tensorACpy.strides());
-        std::fill(ones.datas().begin(), ones.datas().end(), 1);
+        TensorArray<T> ones(_tensorACpy.shape(), _tensorACpy.strides(), TensorArray<T>::InitType::ONES);
         backward(ones);
     }
 
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include "Profiler/Profiler.hpp"
 #include "Tensor/Tensor.hpp"
 #include "Tensor/TensorArray.hpp"
 #include "Tensor/autograd/GradNode.hpp"
@@ -29,6 +30,7 @@ public:
 
     void backward(TensorArray<T> grad) override
     {
+        profiler::Scope profile("ReLUBackward");
         if (this->_nextGrads[0]) {
             this->_nextGrads[0]->backward(grad * _reluRes);
         }
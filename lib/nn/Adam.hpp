@@ -0,0 +1,95 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** Adam
+*/
+
+#pragma once
+
+#include <cmath>
+#include "Optimizer.hpp"
+#include "Parameters.hpp"
+
+namespace lava::nn {
+
+/**
+ *  @brief Adam, or AdamW when the weight decay is decoupled from the gradient.
+ *
+ *  The state buffer holds the first moments of every parameter, then the second moments.
+ *  Bias corrections are folded in two per-step scalars so the inner loop stays branch-free.
+ */
+template <typename T>
+class Adam : public Optimizer<T> {
+    public:
+    Adam(
+        Parameters<T> &parameters,
+        T learningRate = 0.001,
+        T beta1 = 0.9,
+        T beta2 = 0.999,
+        T epsilon = 1e-8,
+        T weightDecay = 0,
+        bool decoupled = false,
+        T maxGrad = 1
+    )
+        : Optimizer<T>(parameters, learningRate, maxGrad, 2),
+          _beta1(beta1),
+          _beta2(beta2),
+          _epsilon(epsilon),
+          _weightDecay(weightDecay),
+          _decoupled(decoupled)
+    {
+        if (beta1 < 0 || beta1 >= 1 || beta2 < 0 || beta2 >= 1) {
+            throw std::runtime_error("Adam betas must be between 0 and 1");
+        }
+    }
+
+    OptimizerType type() const override
+    {
+        return _decoupled ? OptimizerType::ADAMW : OptimizerType::ADAM;
+    }
+
+    protected:
+    void beginStep() override
+    {
+        auto step = static_cast<T>(this->_steps);
+        _stepSize = this->_learningRate / (1 - std::pow(_beta1, step));
+        _secondCorrection = 1 / (1 - std::pow(_beta2, step));
+    }
+
+    void update(T *__restrict datas, const T *__restrict grads, size_t size) override
+    {
+        T *__restrict first = this->_state.data();
+        T *__restrict second = this->_state.data() + size;
+        const T maxGrad = this->_maxGrad;
+        const T scale = this->_gradScale;
+        const T beta1 = _beta1;
+        const T beta2 = _beta2;
+        const T epsilon = _epsilon;
+        const T stepSize = _stepSize;
+        const T correction = _secondCorrection;
+        // AdamW shrinks the weights directly, Adam adds the L2 term to the gradient
+        const T coupledDecay = _decoupled ? T(0) : _weightDecay;
+        const T shrink = _decoupled ? 1 - this->_learningRate * _weightDecay : T(1);
+
+        for (size_t i = 0; i < size; i++) {
+            T grad = this->clipGrad(grads[i], scale, maxGrad) + coupledDecay * datas[i];
+            T m = beta1 * first[i] + (1 - beta1) * grad;
+            T v = beta2 * second[i] + (1 - beta2) * grad * grad;
+            first[i] = m;
+            second[i] = v;
+            datas[i] = datas[i] * shrink - stepSize * m / (std::sqrt(v * correction) + epsilon);
+        }
+    }
+
+    private:
+    T _beta1;
+    T _beta2;
+    T _epsilon;
+    T _weightDecay;
+    bool _decoupled;
+    T _stepSize{0};
+    T _secondCorrection{1};
+};
+
+} // namespace lava::nn
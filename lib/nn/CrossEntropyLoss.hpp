@@ -9,6 +9,7 @@
 
 #include <cmath>
 #include "Module.hpp"
+#include "Profiler/Profiler.hpp"
 #include "Tensor/Tensor.hpp"
 #include "Tensor/autograd/CrossEntropyLossBackward.hpp"
 
@@ -22,6 +23,7 @@ class CrossEntropyLoss {
     // Our specialized forward method for loss computation
     Tensor<T> forward(Tensor<T> &input, size_t targetIndex)
     {
+        profiler::Scope profile("CrossEntropyLoss::forward");
         const T epsilon = 1e-7;
         const auto &inputData = input.tensor().datas();
 
@@ -40,7 +42,7 @@ class CrossEntropyLoss {
         }
 
         // Normalize and compute loss
-        Tensor<T> output({1}, false);
+        Tensor<T> output(TensorArray<T>({1}, TensorArray<T>::InitType::ZERO), false);
         for (size_t i = 0; i < ce.size(); ++i) {
             ce[i] /= sum;
             if (i == targetIndex) {
@@ -48,7 +50,7 @@ class CrossEntropyLoss {
             }
         }
 
-        auto gradNode = std::make_shared<CrossEntropyLossBackward<T>>(input, targetIndex);
+        auto gradNode = makeGradNode<CrossEntropyLossBackward<T>>(input, targetIndex);
         output.setGradNode(gradNode);
 
         return output;
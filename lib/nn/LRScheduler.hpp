@@ -0,0 +1,311 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** LRScheduler
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <numbers>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace lava::nn {
+
+/**
+ *  @brief Learning rate schedule, each schedule only reads the fields it uses.
+ *
+ *  Exponential and step decays count epochs like before, the other schedules follow the optimizer steps.
+ */
+struct SchedulerOptions {
+    std::string type{"none"}; /** none, exponential, step, cosine, one_cycle or plateau */
+    double decayRate{0.95}; /** Factor applied every decaySteps epochs, or on each plateau */
+    size_t decaySteps{100}; /** Epochs between two decays */
+    double minLR{0.0001}; /** Floor of every schedule, end of cosine and one_cycle */
+    size_t warmupSteps{0}; /** Optimizer steps of linear warmup before any schedule */
+    double pctStart{0.3}; /** Fraction of the steps over which one_cycle rises to its peak */
+    size_t patience{5}; /** Epochs without improvement before a plateau decay */
+};
+
+/**
+ *  @brief Learning rate of each optimizer step, from the base (peak) learning rate of the network.
+ *
+ *  learningRate() is the rate of the next step and step() moves to the following one. The warmup ramps
+ *  linearly from baseLR / warmupSteps to the scheduled rate, whatever the schedule.
+ *
+ *  NOTE: The position of the schedule is saved with state() in checkpoints, so a resumed training
+ *        continues the same curve.
+ */
+class LRScheduler {
+    public:
+    LRScheduler(double baseLR, const SchedulerOptions &options, size_t stepsPerEpoch, size_t totalSteps)
+        : _baseLR(baseLR), _options(options), _stepsPerEpoch(std::max(size_t(1), stepsPerEpoch)),
+          _totalSteps(std::max(size_t(1), totalSteps))
+    {
+    }
+
+    virtual ~LRScheduler() = default;
+
+    double learningRate() const
+    {
+        double lr = std::max(scheduled(_step), _options.minLR);
+        if (_step < _options.warmupSteps) {
+            lr *= static_cast<double>(_step + 1) / _options.warmupSteps;
+        }
+        return lr;
+    }
+
+    void step(size_t count = 1)
+    {
+        _step += count;
+    }
+
+    size_t steps() const
+    {
+        return _step;
+    }
+
+    double baseLearningRate() const
+    {
+        return _baseLR;
+    }
+
+    double decayRate() const
+    {
+        return _options.decayRate;
+    }
+
+    /**
+     *  @brief Changes the base rate and the decay rate from the next step on, the position in the
+     *         schedule is kept (population based training explores them this way).
+     */
+    void setHyperparameters(double baseLR, double decayRate)
+    {
+        if (baseLR <= 0 || decayRate <= 0 || decayRate > 1) {
+            throw std::runtime_error("Invalid scheduler hyperparameters");
+        }
+        _baseLR = baseLR;
+        _options.decayRate = decayRate;
+    }
+
+    /**
+     *  @brief Reports the loss monitored at the end of an epoch, only plateau schedules use it.
+     */
+    virtual void observe(double /* loss */) {}
+
+    virtual std::string describe() const
+    {
+        return _options.type;
+    }
+
+    virtual std::string state() const
+    {
+        return std::to_string(_step);
+    }
+
+    virtual void restore(const std::string &state)
+    {
+        std::istringstream in(state);
+        if (!(in >> _step)) {
+            throw std::runtime_error("Invalid learning rate scheduler state");
+        }
+    }
+
+    protected:
+    /**
+     *  @brief Rate of @param step before the warmup and the floor.
+     */
+    virtual double scheduled(size_t step) const = 0;
+
+    size_t epochOf(size_t step) const
+    {
+        return step / _stepsPerEpoch;
+    }
+
+    /**
+     *  @brief Position in [0, 1] of @param step among the steps following the warmup.
+     */
+    double progress(size_t step) const
+    {
+        if (_totalSteps <= _options.warmupSteps) {
+            return 1.0;
+        }
+        size_t after = step > _options.warmupSteps ? step - _options.warmupSteps : 0;
+        return std::min(1.0, static_cast<double>(after) / (_totalSteps - _options.warmupSteps));
+    }
+
+    double _baseLR;
+    SchedulerOptions _options;
+    size_t _stepsPerEpoch;
+    size_t _totalSteps;
+    size_t _step{0};
+};
+
+class ConstantLR : public LRScheduler {
+    public:
+    using LRScheduler::LRScheduler;
+
+    protected:
+    double scheduled(size_t /* step */) const override
+    {
+        return _baseLR;
+    }
+};
+
+/**
+ *  @brief baseLR * decayRate ^ (epoch / decaySteps), lowered a little every epoch.
+ */
+class ExponentialLR : public LRScheduler {
+    public:
+    using LRScheduler::LRScheduler;
+
+    protected:
+    double scheduled(size_t step) const override
+    {
+        return _baseLR * std::pow(_options.decayRate, static_cast<double>(epochOf(step)) / _options.decaySteps);
+    }
+};
+
+/**
+ *  @brief baseLR multiplied by decayRate once every decaySteps epochs.
+ */
+class StepLR : public LRScheduler {
+    public:
+    using LRScheduler::LRScheduler;
+
+    protected:
+    double scheduled(size_t step) const override
+    {
+        return _baseLR * std::pow(_options.decayRate, static_cast<double>(epochOf(step) / _options.decaySteps));
+    }
+};
+
+/**
+ *  @brief Half a cosine from baseLR down to minLR over the whole training.
+ */
+class CosineLR : public LRScheduler {
+    public:
+    using LRScheduler::LRScheduler;
+
+    protected:
+    double scheduled(size_t step) const override
+    {
+        double cosine = (1.0 + std::cos(std::numbers::pi * progress(step))) / 2.0;
+        return _options.minLR + (_baseLR - _options.minLR) * cosine;
+    }
+};
+
+/**
+ *  @brief One-cycle policy: rises from baseLR / 25 to baseLR over the first pctStart of the training,
+ *         then anneals down to minLR, both along a cosine.
+ */
+class OneCycleLR : public LRScheduler {
+    public:
+    using LRScheduler::LRScheduler;
+
+    protected:
+    double scheduled(size_t step) const override
+    {
+        constexpr double START_DIVISOR = 25.0;
+        double t = progress(step);
+        auto anneal = [](double from, double to, double pct) {
+            return to + (from - to) * (1.0 + std::cos(std::numbers::pi * pct)) / 2.0;
+        };
+        if (t < _options.pctStart) {
+            return anneal(_baseLR / START_DIVISOR, _baseLR, t / _options.pctStart);
+        }
+        return anneal(_baseLR, _options.minLR, (t - _options.pctStart) / (1.0 - _options.pctStart));
+    }
+};
+
+/**
+ *  @brief Multiplies the rate by decayRate once the observed loss did not improve by at least 0.01%
+ *         during patience epochs.
+ */
+class PlateauLR : public LRScheduler {
+    public:
+    using LRScheduler::LRScheduler;
+
+    void observe(double loss) override
+    {
+        constexpr double THRESHOLD = 1e-4;
+        if (loss < _best * (1.0 - THRESHOLD)) {
+            _best = loss;
+            _stale = 0;
+        } else if (++_stale >= _options.patience) {
+            _scale *= _options.decayRate;
+            _stale = 0;
+        }
+    }
+
+    std::string state() const override
+    {
+        std::ostringstream out;
+        out.precision(std::numeric_limits<double>::max_digits10);
+        out << LRScheduler::state() << ' ' << _scale << ' ' << _best << ' ' << _stale;
+        return out.str();
+    }
+
+    void restore(const std::string &state) override
+    {
+        std::istringstream in(state);
+        std::string best;
+        if (!(in >> _step >> _scale >> best >> _stale)) {
+            throw std::runtime_error("Invalid plateau scheduler state");
+        }
+        _best = std::stod(best); // Streams do not read back the "inf" they write, strtod does
+    }
+
+    protected:
+    double scheduled(size_t /* step */) const override
+    {
+        return _baseLR * _scale;
+    }
+
+    private:
+    double _scale{1.0};
+    double _best{std::numeric_limits<double>::infinity()};
+    size_t _stale{0};
+};
+
+/**
+ *  @brief Builds the schedule selected by @param options.type.
+ *
+ *  @param stepsPerEpoch Optimizer steps of one epoch
+ *  @param totalSteps Optimizer steps of the whole training
+ */
+inline std::unique_ptr<LRScheduler> makeScheduler(
+    double baseLR,
+    const SchedulerOptions &options,
+    size_t stepsPerEpoch,
+    size_t totalSteps
+)
+{
+    if (options.type == "none") {
+        return std::make_unique<ConstantLR>(baseLR, options, stepsPerEpoch, totalSteps);
+    }
+    if (options.type == "exponential") {
+        return std::make_unique<ExponentialLR>(baseLR, options, stepsPerEpoch, totalSteps);
+    }
+    if (options.type == "step") {
+        return std::make_unique<StepLR>(baseLR, options, stepsPerEpoch, totalSteps);
+    }
+    if (options.type == "cosine") {
+        return std::make_unique<CosineLR>(baseLR, options, stepsPerEpoch, totalSteps);
+    }
+    if (options.type == "one_cycle") {
+        return std::make_unique<OneCycleLR>(baseLR, options, stepsPerEpoch, totalSteps);
+    }
+    if (options.type == "plateau") {
+        return std::make_unique<PlateauLR>(baseLR, options, stepsPerEpoch, totalSteps);
+    }
+    throw std::runtime_error("Unknown learning rate scheduler: " + options.type);
+}
+
+} // namespace lava::nn
@@ -9,31 +9,146 @@
 
 #include <cmath>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
 #include "Module.hpp"
+#include "Tensor/HalfKernels.hpp"
+#include "Tensor/Memory.hpp"
 #include "Tensor/Tensor.hpp"
+#include "Tensor/autograd/HalfLinearBackward.hpp"
 
 namespace lava::nn {
 
 template <typename T>
 class Linear : public Module<T> {
 public:
-    Linear(int inFeatures, int outFeatures):
-        _weights({inFeatures, outFeatures}, true),
-        _biases({outFeatures}, true)
+    /**
+     *  @brief Builds a Linear layer of shape (inFeatures, outFeatures).
+     *
+     *  @param init Initialization of the weights and biases. Use `UNINITIALIZED` when they are
+     *              about to be overwritten (loaded from a file or initialized by the generator).
+     */
+    Linear(
+        int inFeatures,
+        int outFeatures,
+        typename TensorArray<T>::InitType init = TensorArray<T>::InitType::RANDOM
+    ):
+        _weights(TensorArray<T>({inFeatures, outFeatures}, init), true),
+        _biases(TensorArray<T>({outFeatures}, init), true)
     {
+        _weights.datas().setCategory(memory::Category::WEIGHTS);
+        _biases.datas().setCategory(memory::Category::WEIGHTS);
+    }
+
+    /**
+     *  @brief Builds a Linear layer on existing weights and biases, without copying them.
+     *
+     *  @param weights Weights of shape (inFeatures, outFeatures), can be a view on mapped memory
+     *  @param biases Biases of shape (outFeatures)
+     *  @param requiresGrad False for read-only inference: no gradient buffers are allocated
+     */
+    Linear(TensorArray<T> &&weights, TensorArray<T> &&biases, bool requiresGrad = true):
+        _weights(std::move(weights), requiresGrad),
+        _biases(std::move(biases), requiresGrad)
+    {
+        _weights.datas().setCategory(memory::Category::WEIGHTS);
+        _biases.datas().setCategory(memory::Category::WEIGHTS);
     }
 
     ~Linear() override = default;
 
     Tensor<T> forward(Tensor<T> &x) override
     {
+        if constexpr (std::is_same_v<T, float>) {
+            if (_halfFormat) {
+                return halfForward(x);
+            }
+        }
         return x.matmul(this->_weights) + _biases;
     }
 
+    /**
+     *  @brief Runs the next passes on a half copy of the weights, the float32 weights staying the master
+     *         copy the optimizer updates (mixed precision training).
+     *
+     *  NOTE: Only float layers support it. Call refreshHalfWeights() after each update of the weights.
+     */
+    void setHalfPrecision(kernels::HalfFormat format)
+    {
+        if constexpr (!std::is_same_v<T, float>) {
+            (void)format;
+            throw std::runtime_error("Half precision layers need float32 master weights");
+        } else {
+            _halfFormat = format;
+            refreshHalfWeights();
+        }
+    }
+
+    /**
+     *  @brief Rounds the master weights into the transposed (outFeatures, inFeatures) half copy.
+     */
+    void refreshHalfWeights()
+    {
+        if constexpr (std::is_same_v<T, float>) {
+            const size_t in = _weights.shape()[0];
+            const size_t out = _weights.shape()[1];
+            // A copy still referenced by a graph is left untouched
+            if (!_halfWeights || _halfWeights.use_count() > 1) {
+                memory::Scope scope(memory::Category::WEIGHTS);
+                _halfWeights = std::make_shared<Storage<uint16_t>>(in * out);
+            }
+            _transposed.resize(in * out);
+            const float *weights = _weights.datas().data();
+            for (size_t k = 0; k < in; k++) {
+                for (size_t j = 0; j < out; j++) {
+                    _transposed[j * in + k] = weights[k * out + j];
+                }
+            }
+            kernels::toHalf(*_halfFormat, _transposed.data(), _halfWeights->data(), in * out);
+        }
+    }
+
+    void collectParameters(std::vector<Tensor<T> *> &tensors) override
+    {
+        tensors.push_back(&_weights);
+        tensors.push_back(&_biases);
+    }
+
     // Only weights and biases as Tensor
     Tensor<T> _weights;
     Tensor<T> _biases;
 private:
+    Tensor<T> halfForward(Tensor<T> &x)
+    {
+        const size_t in = _weights.shape()[0];
+        const size_t out = _weights.shape()[1];
+        const size_t rows = x.datas().size() / in;
+        std::vector<int> shape = {static_cast<int>(rows), static_cast<int>(out)};
+        if (x.shape().size() == 1) {
+            shape.erase(shape.begin());
+        }
+
+        TensorArray<T> result(shape, Storage<T>(rows * out));
+        T *values = result.datas().data();
+        for (size_t r = 0; r < rows; r++) {
+            kernels::gemvHalf(*_halfFormat, x.datas().data() + r * in, _halfWeights->data(), out, in, values + r * out);
+            for (size_t j = 0; j < out; j++) {
+                values[r * out + j] += _biases.datas()[j];
+            }
+        }
+        if (!_weights.requiresGrad()) {
+            return Tensor<T>(std::move(result), false);
+        }
+        auto gradNode = makeGradNode<HalfLinearBackward>(x, _weights, _biases, _halfWeights, *_halfFormat);
+        return Tensor<T>(result, gradNode, true);
+    }
+
+    std::optional<kernels::HalfFormat> _halfFormat;
+    std::shared_ptr<Storage<uint16_t>> _halfWeights; /** Transposed half weights, shared with the graphs */
+    std::vector<T> _transposed; /** Scratch buffer of refreshHalfWeights() */
 };
 
 }
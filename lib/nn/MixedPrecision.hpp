@@ -0,0 +1,130 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** MixedPrecision
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Linear.hpp"
+#include "Optimizer.hpp"
+#include "Profiler/Profiler.hpp"
+#include "Sequential.hpp"
+#include "Tensor/HalfKernels.hpp"
+
+namespace lava::nn {
+
+struct MixedPrecisionOptions {
+    std::string type{"none"}; /** none, bf16 or fp16 */
+    double lossScale{65536.0}; /** Initial loss scale */
+    size_t growthInterval{2000}; /** Steps without overflow before the loss scale doubles */
+};
+
+/**
+ *  @tparam Type of the master weights, only float networks can run in half precision.
+ *
+ *  @brief Mixed precision training: the Linear layers compute on half copies of the float32 master weights,
+ *         which the optimizer keeps updating in float32.
+ *
+ *  The loss gradient is multiplied by a dynamic loss scale so small gradients do not vanish in half
+ *  precision. A step whose gradients overflowed is skipped and halves the scale, growthInterval
+ *  successful steps double it.
+ */
+template <typename T>
+class MixedPrecision {
+    public:
+    MixedPrecision(Sequential<T> &net, const MixedPrecisionOptions &options)
+        : _scale(static_cast<T>(options.lossScale)), _growthInterval(options.growthInterval)
+    {
+        if (options.type == "bf16") {
+            _format = kernels::HalfFormat::BF16;
+        } else if (options.type == "fp16") {
+            _format = kernels::HalfFormat::FP16;
+        } else {
+            throw std::runtime_error("Unknown mixed precision type: " + options.type + " (expected bf16 or fp16)");
+        }
+        for (const auto &layer : net.layers()) {
+            if (auto linear = std::dynamic_pointer_cast<Linear<T>>(layer)) {
+                linear->setHalfPrecision(_format);
+                _layers.push_back(linear);
+            }
+        }
+    }
+
+    T lossScale() const
+    {
+        return _scale;
+    }
+
+    size_t skippedSteps() const
+    {
+        return _skippedSteps;
+    }
+
+    std::string describe() const
+    {
+        std::ostringstream out;
+        out << kernels::halfFormatName(_format) << " (" << kernels::halfKernelName(kernels::halfKernel())
+            << " kernels, loss scale " << _scale << ")";
+        return out.str();
+    }
+
+    /**
+     *  @brief Back-propagates @param loss, computed on @param output, multiplied by the loss scale.
+     */
+    void backward(Tensor<T> &loss, const Tensor<T> &output) const
+    {
+        profiler::Scope profile("MixedPrecision::backward");
+        const auto &values = output.tensor();
+        TensorArray<T> seed(values.shape(), values.strides(), TensorArray<T>::InitType::UNINITIALIZED);
+        std::fill(seed.datas().begin(), seed.datas().end(), _scale);
+        loss.gradNode()->backward(std::move(seed));
+    }
+
+    /**
+     *  @brief Unscales the gradients summed over @param accumulated micro-batches and steps @param optimizer,
+     *         unless they overflowed. The half weights are then refreshed from the updated master weights.
+     *
+     *  @return False when the step was skipped.
+     */
+    bool step(Optimizer<T> &optimizer, const T *grads, size_t size)
+    {
+        bool finite = true;
+        for (size_t i = 0; i < size; i++) {
+            finite &= grads[i] - grads[i] == 0; // Only 0 for finite values
+        }
+        if (!finite) {
+            _scale = std::max(_scale / 2, T(1));
+            _goodSteps = 0;
+            _skippedSteps++;
+            return false;
+        }
+
+        optimizer.step();
+        for (const auto &linear : _layers) {
+            linear->refreshHalfWeights();
+        }
+        if (_growthInterval > 0 && ++_goodSteps == _growthInterval) {
+            _scale *= 2;
+            _goodSteps = 0;
+        }
+        return true;
+    }
+
+    private:
+    kernels::HalfFormat _format{kernels::HalfFormat::BF16};
+    std::vector<std::shared_ptr<Linear<T>>> _layers;
+    T _scale;
+    size_t _growthInterval;
+    size_t _goodSteps{0};
+    size_t _skippedSteps{0};
+};
+
+} // namespace lava::nn
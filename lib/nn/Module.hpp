@@ -7,13 +7,26 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
 #include "Tensor/Tensor.hpp"
+#include "nn/Parameters.hpp"
 
 namespace lava::nn {
 
 template <typename T>
 class Module {
     public:
+    Module() = default;
+
+    // A copy owns its own tensors, it packs them again when needed
+    Module(const Module &) {}
+
+    Module &operator=(const Module &)
+    {
+        return *this;
+    }
+
     virtual ~Module() = default;
 
     virtual Tensor<T> forward(Tensor<T> &input) = 0;
@@ -22,6 +35,32 @@ class Module {
     {
         return forward(input);
     }
+
+    /**
+     *  @brief Trainable tensors of the module and its children, packed in contiguous arenas.
+     *
+     *  NOTE: The arenas are built on the first call. Modules added afterwards are not part of them.
+     */
+    Parameters<T> &parameters()
+    {
+        if (!_parameters) {
+            std::vector<Tensor<T> *> tensors;
+            collectParameters(tensors);
+            _parameters = std::make_unique<Parameters<T>>(std::move(tensors));
+        }
+        return *_parameters;
+    }
+
+    /**
+     *  @brief Appends the trainable tensors of the module to @param tensors, in a stable order.
+     */
+    virtual void collectParameters(std::vector<Tensor<T> *> &tensors)
+    {
+        (void)tensors;
+    }
+
+    private:
+    std::unique_ptr<Parameters<T>> _parameters;
 };
 
 } // namespace lava::nn
@@ -0,0 +1,213 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** Optimizer
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include "Parameters.hpp"
+#include "Profiler/Profiler.hpp"
+#include "Tensor/Memory.hpp"
+
+namespace lava::nn {
+
+/**
+ *  @brief Update rules available. The values are stored in network files, do not reorder them.
+ */
+enum class OptimizerType : uint32_t {
+    SGD = 0,
+    MOMENTUM = 1,
+    NESTEROV = 2,
+    ADAM = 3,
+    ADAMW = 4
+};
+
+inline OptimizerType optimizerTypeFromString(const std::string &name)
+{
+    if (name == "sgd") {
+        return OptimizerType::SGD;
+    }
+    if (name == "momentum") {
+        return OptimizerType::MOMENTUM;
+    }
+    if (name == "nesterov") {
+        return OptimizerType::NESTEROV;
+    }
+    if (name == "adam") {
+        return OptimizerType::ADAM;
+    }
+    if (name == "adamw") {
+        return OptimizerType::ADAMW;
+    }
+    throw std::runtime_error("Unknown optimizer: " + name);
+}
+
+inline const char *optimizerTypeName(OptimizerType type)
+{
+    switch (type) {
+        case OptimizerType::MOMENTUM:
+            return "momentum";
+        case OptimizerType::NESTEROV:
+            return "nesterov";
+        case OptimizerType::ADAM:
+            return "adam";
+        case OptimizerType::ADAMW:
+            return "adamw";
+        default:
+            return "sgd";
+    }
+}
+
+/**
+ *  @brief Hyperparameters of the optimizers, each one only reads the fields it uses.
+ */
+struct OptimizerOptions {
+    OptimizerType type{OptimizerType::SGD};
+    double momentum{0.9};
+    double beta1{0.9};
+    double beta2{0.999};
+    double epsilon{1e-8};
+    double weightDecay{0.0};
+    double maxGrad{1.0}; /** Element-wise gradient clipping bound */
+};
+
+/**
+ *  @tparam Type of the parameters.
+ *
+ *  @brief Base class of the fused optimizers, working on the parameter arenas of a module.
+ *
+ *  The optimizer state (momentum, moments, ...) lives in one flat buffer of
+ *  stateSlots * parameterCount() elements, slot after slot, indexed like the arenas. A step is a
+ *  single pass over the arenas: gradient sanitizing and clipping, state update and weight update
+ *  are fused in one branch-free loop the compiler can vectorize.
+ *
+ *  NOTE: Non-finite gradients are treated as zero.
+ */
+template <typename T>
+class Optimizer {
+    public:
+    Optimizer(Parameters<T> &parameters, T learningRate, T maxGrad, size_t stateSlots)
+        : _learningRate(learningRate), _maxGrad(maxGrad), _parameters(parameters)
+    {
+        memory::Scope scope(memory::Category::OPTIMIZER);
+        _state = Storage<T>(stateSlots * parameters.size(), T(0));
+    }
+
+    virtual ~Optimizer() = default;
+
+    virtual OptimizerType type() const = 0;
+
+    void zeroGrad()
+    {
+        profiler::Scope profile("Optimizer::zeroGrad");
+        _parameters.zeroGrad();
+    }
+
+    void step()
+    {
+        profiler::Scope profile("Optimizer::step");
+        _steps++;
+        beginStep();
+        update(_parameters.datas(), _parameters.grads(), _parameters.size());
+    }
+
+    void setLearningRate(T lr)
+    {
+        if (lr <= 0) {
+            throw std::runtime_error("Learning rate must be greater than 0");
+        }
+        _learningRate = lr;
+    }
+
+    T getLearningRate() const
+    {
+        return _learningRate;
+    }
+
+    /**
+     *  @brief Factor applied to the gradients by the next steps, before clipping.
+     *
+     *  NOTE: Used to average gradients accumulated over several micro-batches without an extra
+     *        pass over the arena.
+     */
+    void setGradScale(T scale)
+    {
+        _gradScale = scale;
+    }
+
+    size_t parameterCount() const
+    {
+        return _parameters.size();
+    }
+
+    /**
+     *  @brief Number of steps done, restored with the state when resuming a training.
+     */
+    uint64_t steps() const
+    {
+        return _steps;
+    }
+
+    void setSteps(uint64_t steps)
+    {
+        _steps = steps;
+    }
+
+    /**
+     *  @brief Drops the state (momentum, moments) and the step count, as for freshly loaded weights.
+     */
+    void reset()
+    {
+        std::fill(_state.begin(), _state.end(), T(0));
+        _steps = 0;
+    }
+
+    Storage<T> &state()
+    {
+        return _state;
+    }
+
+    const Storage<T> &state() const
+    {
+        return _state;
+    }
+
+    protected:
+    /**
+     *  @brief Called once per step, before the updates, to compute the per-step scalars.
+     */
+    virtual void beginStep() {}
+
+    /**
+     *  @brief Updates the @param size parameters of the arenas, and their state.
+     */
+    virtual void update(T *datas, const T *grads, size_t size) = 0;
+
+    /**
+     *  @brief Scales a gradient, replaces it by 0 if it is not finite (x - x is only 0 for finite values)
+     *         and clips it.
+     */
+    static T clipGrad(T grad, T scale, T maxGrad)
+    {
+        grad *= scale;
+        grad = (grad - grad == 0) ? grad : T(0);
+        return std::min(std::max(grad, -maxGrad), maxGrad);
+    }
+
+    T _learningRate;
+    T _maxGrad;
+    T _gradScale{1};
+    Storage<T> _state;
+    uint64_t _steps{0};
+
+    private:
+    Parameters<T> &_parameters;
+};
+
+} // namespace lava::nn
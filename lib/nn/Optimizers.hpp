@@ -0,0 +1,59 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** Optimizers
+*/
+
+#pragma once
+
+#include <memory>
+#include "Adam.hpp"
+#include "Optimizer.hpp"
+#include "Parameters.hpp"
+#include "SGD.hpp"
+
+namespace lava::nn {
+
+/**
+ *  @brief Builds the optimizer selected by @param options.type on @param parameters.
+ */
+template <typename T>
+std::unique_ptr<Optimizer<T>> makeOptimizer(
+    Parameters<T> &parameters,
+    T learningRate,
+    const OptimizerOptions &options
+)
+{
+    auto maxGrad = static_cast<T>(options.maxGrad);
+    auto weightDecay = static_cast<T>(options.weightDecay);
+
+    switch (options.type) {
+        case OptimizerType::ADAM:
+        case OptimizerType::ADAMW:
+            return std::make_unique<Adam<T>>(
+                parameters,
+                learningRate,
+                static_cast<T>(options.beta1),
+                static_cast<T>(options.beta2),
+                static_cast<T>(options.epsilon),
+                weightDecay,
+                options.type == OptimizerType::ADAMW,
+                maxGrad
+            );
+        case OptimizerType::MOMENTUM:
+        case OptimizerType::NESTEROV:
+            return std::make_unique<SGD<T>>(
+                parameters,
+                learningRate,
+                static_cast<T>(options.momentum),
+                options.type == OptimizerType::NESTEROV,
+                weightDecay,
+                maxGrad
+            );
+        default:
+            return std::make_unique<SGD<T>>(parameters, learningRate, T(0), false, weightDecay, maxGrad);
+    }
+}
+
+} // namespace lava::nn
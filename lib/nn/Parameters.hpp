@@ -0,0 +1,136 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** Parameters
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "Tensor/Memory.hpp"
+#include "Tensor/Tensor.hpp"
+
+namespace lava::nn {
+
+/**
+ *  @tparam Type of the parameters.
+ *
+ *  @brief Trainable tensors of a module, packed in two contiguous arenas: one for the values
+ *         and one for the gradients.
+ *
+ *  The tensors keep their shapes but their storages become views on the arenas, so a whole
+ *  network can be updated, zeroed, reduced or written with a single pass over one buffer.
+ *
+ *  NOTE: Every tensor starts on a 64-byte boundary, which gives the layout of the data section
+ *        of a version 2 `.nn` file. The padding between tensors stays 0 in both arenas.
+ */
+template <typename T>
+class Parameters {
+    public:
+    /**
+     *  @brief Moves the values of @param tensors in the arenas and rebinds them on it.
+     *         Their gradients are reset to 0.
+     */
+    explicit Parameters(std::vector<Tensor<T> *> tensors) : _tensors(std::move(tensors))
+    {
+        for (auto *tensor : _tensors) {
+            _offsets.push_back(_size);
+            _size = alignedCount(_size + tensor->datas().size());
+        }
+        {
+            memory::Scope scope(memory::Category::WEIGHTS);
+            _datas = std::make_shared<Storage<T>>(_size, T(0));
+        }
+        {
+            memory::Scope scope(memory::Category::GRADS);
+            _grads = std::make_shared<Storage<T>>(_size, T(0));
+        }
+
+        for (size_t i = 0; i < _tensors.size(); i++) {
+            auto &tensor = *_tensors[i];
+            size_t count = tensor.datas().size();
+            T *datas = _datas->data() + _offsets[i];
+            T *grads = _grads->data() + _offsets[i];
+
+            std::copy(tensor.datas().begin(), tensor.datas().end(), datas);
+            tensor.tensor() = TensorArray<T>(tensor.shape(), Storage<T>::view(datas, count, _datas));
+            tensor.grad() = TensorArray<T>(tensor.shape(), Storage<T>::view(grads, count, _grads));
+            tensor.setRequiresGrad(true);
+        }
+    }
+
+    const std::vector<Tensor<T> *> &tensors() const
+    {
+        return _tensors;
+    }
+
+    /**
+     *  @brief Number of elements of each arena, padding included.
+     */
+    size_t size() const
+    {
+        return _size;
+    }
+
+    /**
+     *  @brief Index of the first element of @param tensor in the arenas.
+     */
+    size_t offsetOf(const Tensor<T> &tensor) const
+    {
+        auto it = std::find(_tensors.begin(), _tensors.end(), &tensor);
+        if (it == _tensors.end()) {
+            throw std::logic_error("[ERR] Tensor is not a parameter of this module");
+        }
+        return _offsets[it - _tensors.begin()];
+    }
+
+    T *datas()
+    {
+        return _datas->data();
+    }
+
+    const T *datas() const
+    {
+        return _datas->data();
+    }
+
+    T *grads()
+    {
+        return _grads->data();
+    }
+
+    const T *grads() const
+    {
+        return _grads->data();
+    }
+
+    void zeroGrad()
+    {
+        if (_size > 0) {
+            std::memset(grads(), 0, _size * sizeof(T));
+        }
+    }
+
+    /**
+     *  @brief Rounds @param count up to a whole number of 64-byte blocks.
+     */
+    static constexpr size_t alignedCount(size_t count)
+    {
+        constexpr size_t block = Storage<T>::ALIGNMENT / sizeof(T);
+        return (count + block - 1) / block * block;
+    }
+
+    private:
+    std::vector<Tensor<T> *> _tensors;
+    std::vector<size_t> _offsets;
+    size_t _size{0};
+    std::shared_ptr<Storage<T>> _datas;
+    std::shared_ptr<Storage<T>> _grads;
+};
+
+} // namespace lava::nn
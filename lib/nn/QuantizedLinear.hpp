@@ -0,0 +1,149 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** QuantizedLinear
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "Tensor/Int8Kernels.hpp"
+#include "Tensor/Storage.hpp"
+#include "nn/Linear.hpp"
+
+namespace lava::nn {
+
+/**
+ *  @brief Inference-only int8 Linear layer.
+ *
+ *  Weights are quantized per output channel (symmetric, scale = max|w| / 127) and stored
+ *  transposed, one padded row per output, so each output is a contiguous int8 dot product.
+ *  Inputs are quantized with the per-tensor scale found during calibration, to [0, 127].
+ *
+ *  NOTE: The inputs of a quantized layer must be non-negative (one-hot boards, ReLU outputs).
+ */
+class QuantizedLinear {
+    public:
+    QuantizedLinear(
+        size_t inFeatures,
+        size_t outFeatures,
+        Storage<int8_t> &&weights,
+        Storage<float> &&biases,
+        Storage<float> &&weightScales,
+        float inputScale
+    )
+        : _inFeatures(inFeatures), _outFeatures(outFeatures), _stride(kernels::int8PaddedSize(inFeatures)),
+          _weights(std::move(weights)), _biases(std::move(biases)), _weightScales(std::move(weightScales)),
+          _inputScale(inputScale)
+    {
+        if (_weights.size() != _outFeatures * _stride || _biases.size() != _outFeatures ||
+            _weightScales.size() != _outFeatures) {
+            throw std::runtime_error("Invalid quantized layer dimensions");
+        }
+    }
+
+    /**
+     *  @brief Quantizes a trained Linear layer.
+     *
+     *  @param inputMax Largest input value seen during calibration, mapped to 127
+     */
+    template <typename T>
+    static QuantizedLinear fromLinear(const Linear<T> &linear, float inputMax)
+    {
+        const auto &w = linear._weights.tensor();
+        size_t in = w.shape()[0];
+        size_t out = w.shape()[1];
+        size_t stride = kernels::int8PaddedSize(in);
+
+        Storage<int8_t> weights(out * stride, 0);
+        Storage<float> biases(out);
+        Storage<float> scales(out);
+        for (size_t j = 0; j < out; j++) {
+            T maxAbs = 0;
+            for (size_t i = 0; i < in; i++) {
+                maxAbs = std::max(maxAbs, std::abs(w.datas()[i * out + j]));
+            }
+            scales[j] = maxAbs > 0 ? static_cast<float>(maxAbs) / 127.0f : 1.0f;
+            for (size_t i = 0; i < in; i++) {
+                float q = std::round(static_cast<float>(w.datas()[i * out + j]) / scales[j]);
+                weights[j * stride + i] = static_cast<int8_t>(std::clamp(q, -127.0f, 127.0f));
+            }
+            biases[j] = static_cast<float>(linear._biases.tensor().datas()[j]);
+        }
+
+        float inputScale = inputMax > 0 ? inputMax / 127.0f : 1.0f;
+        return {in, out, std::move(weights), std::move(biases), std::move(scales), inputScale};
+    }
+
+    /**
+     *  @brief Computes @param output (outFeatures floats) from @param input (inFeatures floats).
+     *
+     *  @param scratch Buffer of at least stride() bytes for the quantized input
+     *  @param accumulators Buffer of at least outFeatures() int32
+     */
+    void forward(const float *input, float *output, int8_t *scratch, int32_t *accumulators) const
+    {
+        const float invScale = 1.0f / _inputScale;
+        for (size_t i = 0; i < _inFeatures; i++) {
+            float q = std::round(input[i] * invScale);
+            scratch[i] = static_cast<int8_t>(std::clamp(q, 0.0f, 127.0f));
+        }
+        std::fill(scratch + _inFeatures, scratch + _stride, int8_t{0});
+
+        kernels::gemvInt8(scratch, _weights.data(), _outFeatures, _stride, accumulators);
+
+        for (size_t j = 0; j < _outFeatures; j++) {
+            output[j] = static_cast<float>(accumulators[j]) * _inputScale * _weightScales[j] + _biases[j];
+        }
+    }
+
+    size_t inFeatures() const
+    {
+        return _inFeatures;
+    }
+
+    size_t outFeatures() const
+    {
+        return _outFeatures;
+    }
+
+    size_t stride() const
+    {
+        return _stride;
+    }
+
+    float inputScale() const
+    {
+        return _inputScale;
+    }
+
+    const Storage<int8_t> &weights() const
+    {
+        return _weights;
+    }
+
+    const Storage<float> &biases() const
+    {
+        return _biases;
+    }
+
+    const Storage<float> &weightScales() const
+    {
+        return _weightScales;
+    }
+
+    private:
+    size_t _inFeatures;
+    size_t _outFeatures;
+    size_t _stride;               /** Padded row length of the transposed weights */
+    Storage<int8_t> _weights;     /** (outFeatures, stride) int8 weights */
+    Storage<float> _biases;       /** Biases kept in float */
+    Storage<float> _weightScales; /** Per output channel dequantization scale */
+    float _inputScale;            /** Per-tensor input quantization scale */
+};
+
+} // namespace lava::nn
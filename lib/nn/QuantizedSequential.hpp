@@ -0,0 +1,70 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** QuantizedSequential
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "Tensor/Int8Kernels.hpp"
+#include "nn/QuantizedLinear.hpp"
+
+namespace lava::nn {
+
+/**
+ *  @brief Inference-only stack of int8 Linear layers, each one optionally followed by a ReLU.
+ */
+class QuantizedSequential {
+    public:
+    void addLayer(QuantizedLinear &&layer, bool relu)
+    {
+        _maxWidth = std::max({_maxWidth, layer.stride(), layer.outFeatures()});
+        _layers.push_back(std::move(layer));
+        _relus.push_back(relu);
+    }
+
+    /**
+     *  @brief Runs the network on @param input and returns the float logits.
+     */
+    template <typename T>
+    std::vector<float> forward(const std::vector<T> &input) const
+    {
+        std::vector<float> current(input.begin(), input.end());
+        std::vector<float> next;
+        std::vector<int8_t> scratch(_maxWidth);
+        std::vector<int32_t> accumulators(_maxWidth);
+
+        for (size_t i = 0; i < _layers.size(); i++) {
+            next.resize(_layers[i].outFeatures());
+            _layers[i].forward(current.data(), next.data(), scratch.data(), accumulators.data());
+            if (_relus[i]) {
+                for (auto &v : next) {
+                    v = std::max(v, 0.0f);
+                }
+            }
+            std::swap(current, next);
+        }
+        return current;
+    }
+
+    const std::vector<QuantizedLinear> &layers() const
+    {
+        return _layers;
+    }
+
+    bool hasRelu(size_t layer) const
+    {
+        return _relus[layer];
+    }
+
+    private:
+    std::vector<QuantizedLinear> _layers;
+    std::vector<bool> _relus;
+    size_t _maxWidth{0};
+};
+
+} // namespace lava::nn
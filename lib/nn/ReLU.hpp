@@ -24,14 +24,16 @@ class ReLU : public Module<T> {
 
     Tensor<T> forward(Tensor<T> &input) override
     {
-        Tensor<T> output({static_cast<int>(input.datas().size())});
+        Tensor<T> output(
+            TensorArray<T>({static_cast<int>(input.datas().size())}, TensorArray<T>::InitType::UNINITIALIZED)
+        );
 
         // ReLU forward: max(0, x)
         for (size_t i = 0; i < input.datas().size(); ++i) {
             output[i] = std::max(static_cast<T>(0), input[i]);
         }
 
-        auto gradNode = std::make_shared<ReLUBackward<T>>(input);
+        auto gradNode = makeGradNode<ReLUBackward<T>>(input);
         output.setGradNode(gradNode);
 
         return output;
@@ -7,86 +7,118 @@
 
 #pragma once
 
-#include <cmath>
-#include <memory>
-#include <vector>
-#include "Linear.hpp"
-#include "Module.hpp"
+#include "Optimizer.hpp"
+#include "Parameters.hpp"
+#include "Profiler/Profiler.hpp"
 
 namespace lava::nn {
 
+/**
+ *  @brief Stochastic gradient descent, with optional (Nesterov) momentum and L2 weight decay.
+ *
+ *  With momentum the velocity v of each parameter is kept in the state buffer:
+ *      v = momentum * v + g
+ *      w -= lr * v                     (classical)
+ *      w -= lr * (g + momentum * v)    (Nesterov)
+ */
 template <typename T>
-class SGD {
+class SGD : public Optimizer<T> {
     public:
-    SGD(const std::vector<std::shared_ptr<Module<T>>> &layers, T learningRate = 0.01)
-        : _layers(layers), _learningRate(learningRate)
+    SGD(
+        Parameters<T> &parameters,
+        T learningRate = 0.01,
+        T momentum = 0,
+        bool nesterov = false,
+        T weightDecay = 0,
+        T maxGrad = 1
+    )
+        : Optimizer<T>(parameters, learningRate, maxGrad, momentum > 0 ? 1 : 0),
+          _momentum(momentum),
+          _nesterov(nesterov),
+          _weightDecay(weightDecay)
     {
+        if (momentum < 0 || momentum >= 1) {
+            throw std::runtime_error("Momentum must be between 0 and 1");
+        }
     }
 
-    void zeroGrad()
+    OptimizerType type() const override
     {
-        for (auto &layer : _layers) {
-            if (auto *linear = dynamic_cast<Linear<T> *>(layer.get())) {
-                auto &weightGrad = linear->_weights.grad().datas();
-                std::fill(weightGrad.begin(), weightGrad.end(), 0);
-
-                auto &biasGrad = linear->_biases.grad().datas();
-                std::fill(biasGrad.begin(), biasGrad.end(), 0);
-            }
+        if (_momentum == 0) {
+            return OptimizerType::SGD;
         }
+        return _nesterov ? OptimizerType::NESTEROV : OptimizerType::MOMENTUM;
     }
 
-    void step()
+    /**
+     *  @brief Hogwild! update: applies the private gradients @param grads of a worker to the shared
+     *         parameters @param datas, and clears them.
+     *
+     *  Blocks of 64 bytes whose gradients are all 0 (eg. the first layer rows of the inactive one-hot
+     *  inputs) are skipped, so concurrent workers mostly write disjoint cache lines. There is no
+     *  synchronization: the races on the shared weights are benign by design.
+     *
+     *  NOTE: @param size must be a whole number of blocks, which the parameter arenas are. The weight
+     *        decay is only applied to the blocks that have a gradient.
+     */
+    static void sparseStep(T *datas, T *__restrict grads, size_t size, T learningRate, T weightDecay, T maxGrad)
     {
-        const T maxGrad = 1.0;
-
-        for (auto &layer : _layers) {
-            if (auto *linear = dynamic_cast<Linear<T> *>(layer.get())) {
-                auto &weights = linear->_weights;
-                auto &weightData = weights.tensor().datas();
-                const auto &gradData = weights.grad().datas();
+        profiler::Scope profile("SGD::sparseStep");
+        constexpr size_t block = Parameters<T>::alignedCount(1);
 
-                for (size_t i = 0; i < weightData.size(); ++i) {
-                    T grad = gradData[i];
-                    if (std::isnan(grad) || std::isinf(grad)) {
-                        continue;
-                    }
-                    grad = std::max(std::min(grad, maxGrad), -maxGrad);
-                    weightData[i] -= _learningRate * grad;
-                }
-
-                auto &biases = linear->_biases;
-                auto &biasData = biases.tensor().datas();
-                const auto &biasGradData = biases.grad().datas();
-
-                for (size_t i = 0; i < biasData.size(); ++i) {
-                    T grad = biasGradData[i];
-                    if (std::isnan(grad) || std::isinf(grad)) {
-                        continue;
-                    }
-                    grad = std::max(std::min(grad, maxGrad), -maxGrad);
-                    biasData[i] -= _learningRate * grad;
-                }
+        for (size_t start = 0; start < size; start += block) {
+            bool touched = false;
+            for (size_t i = start; i < start + block; i++) {
+                touched |= grads[i] != 0;
+            }
+            if (!touched) {
+                continue;
+            }
+            for (size_t i = start; i < start + block; i++) {
+                datas[i] -= learningRate * (Optimizer<T>::clipGrad(grads[i], T(1), maxGrad) + weightDecay * datas[i]);
+                grads[i] = 0;
             }
         }
     }
 
-    void setLearningRate(T lr)
+    protected:
+    void update(T *__restrict datas, const T *__restrict grads, size_t size) override
     {
-        if (lr <= 0) {
-            throw std::runtime_error("Learning rate must be greater than 0");
+        const T lr = this->_learningRate;
+        const T maxGrad = this->_maxGrad;
+        const T scale = this->_gradScale;
+        const T decay = _weightDecay;
+        const T mu = _momentum;
+
+        if (mu == 0) {
+            for (size_t i = 0; i < size; i++) {
+                datas[i] -= lr * (this->clipGrad(grads[i], scale, maxGrad) + decay * datas[i]);
+            }
+            return;
         }
-        _learningRate = lr;
-    }
 
-    T getLearningRate() const
-    {
-        return _learningRate;
+        T *__restrict velocity = this->_state.data();
+        if (_nesterov) {
+            for (size_t i = 0; i < size; i++) {
+                T grad = this->clipGrad(grads[i], scale, maxGrad) + decay * datas[i];
+                T v = mu * velocity[i] + grad;
+                velocity[i] = v;
+                datas[i] -= lr * (grad + mu * v);
+            }
+        } else {
+            for (size_t i = 0; i < size; i++) {
+                T grad = this->clipGrad(grads[i], scale, maxGrad) + decay * datas[i];
+                T v = mu * velocity[i] + grad;
+                velocity[i] = v;
+                datas[i] -= lr * v;
+            }
+        }
     }
 
     private:
-    const std::vector<std::shared_ptr<Module<T>>> &_layers;
-    T _learningRate;
+    T _momentum;
+    bool _nesterov;
+    T _weightDecay;
 };
 
 } // namespace lava::nn
@@ -7,10 +7,14 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <iostream>
 
+#include "Profiler/Profiler.hpp"
+#include "Tensor/Memory.hpp"
 #include "Tensor/Tensor.hpp"
+#include "Tensor/autograd/CheckpointBackward.hpp"
 #include "nn/Module.hpp"
 #include <initializer_list>
 
@@ -27,6 +31,11 @@ class Sequential : public Module<T> {
 
     Tensor<T> forward(Tensor<T> &in) override
     {
+        profiler::Scope profile("Sequential::forward");
+        memory::Scope activations(memory::Category::ACTIVATIONS);
+        if (_checkpointSegment > 0) {
+            return checkpointedForward(in);
+        }
         Tensor<T> out{in};
         for (auto &mod : _modules) {
             out = mod->forward(out);
@@ -34,6 +43,30 @@ class Sequential : public Module<T> {
         return out;
     }
 
+    /**
+     *  @brief Enables activation checkpointing: the layers are run in segments of @param layers, and only the
+     *         segment inputs are kept for the backward pass, which recomputes the rest.
+     *
+     *  Trades about one extra forward pass for the memory of the activations and saved tensors inside the
+     *  segments. 0 disables it.
+     */
+    void setCheckpointSegment(size_t layers)
+    {
+        _checkpointSegment = layers;
+    }
+
+    size_t checkpointSegment() const
+    {
+        return _checkpointSegment;
+    }
+
+    void collectParameters(std::vector<Tensor<T> *> &tensors) override
+    {
+        for (auto &mod : _modules) {
+            mod->collectParameters(tensors);
+        }
+    }
+
     const std::vector<std::shared_ptr<Module<T>>> &layers() const
     {
         return _modules;
@@ -45,7 +78,37 @@ class Sequential : public Module<T> {
     }
 
     private:
+    Tensor<T> runSegment(Tensor<T> &in, size_t begin, size_t end)
+    {
+        Tensor<T> out{in};
+        for (size_t i = begin; i < end; i++) {
+            out = _modules[i]->forward(out);
+        }
+        return out;
+    }
+
+    Tensor<T> checkpointedForward(Tensor<T> &in)
+    {
+        Tensor<T> out{in};
+        for (size_t begin = 0; begin < _modules.size(); begin += _checkpointSegment) {
+            size_t end = std::min(begin + _checkpointSegment, _modules.size());
+            // The graph of the segment is built on a detached input and dropped with `result`
+            Tensor<T> detached(out.tensor(), false);
+            Tensor<T> result = runSegment(detached, begin, end);
+            if (!result.gradNode()) {
+                out = result;
+                continue;
+            }
+            auto gradNode = makeGradNode<CheckpointBackward<T>>(
+                out, result, [this, begin, end](Tensor<T> &input) { return runSegment(input, begin, end); }
+            );
+            out = Tensor<T>(result.tensor(), gradNode, true);
+        }
+        return out;
+    }
+
     std::vector<std::shared_ptr<Module<T>>> _modules; // Enhance this
+    size_t _checkpointSegment{0}; /** Layers per activation checkpointing segment, 0 when disabled */
 };
 
 } // namespace lava::nn
@@ -30,7 +30,8 @@ class Softmax : public Module<T> {
     Tensor<T> softmax(Tensor<T> &input)
     {
         const auto &inputData = input.tensor().datas();
-        auto output = Tensor<T>({static_cast<int>(inputData.size())});
+        auto output =
+            Tensor<T>(TensorArray<T>({static_cast<int>(inputData.size())}, TensorArray<T>::InitType::UNINITIALIZED));
 
         // Find max for numerical stability
         T maxVal = inputData[0];
@@ -58,7 +59,7 @@ class Softmax : public Module<T> {
     {
         auto output = softmax(input);
 
-        auto gradNode = std::make_shared<SoftmaxBackward<T>>(input);
+        auto gradNode = makeGradNode<SoftmaxBackward<T>>(input);
         output.setGradNode(gradNode);
 
         return output;
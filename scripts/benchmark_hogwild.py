@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+import configparser
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import time
+from typing import Dict
+
+ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__), '..'))
+GENERATOR = os.path.join(ROOT, 'my_torch_generator')
+ANALYZER = os.path.join(ROOT, 'my_torch_analyzer')
+EPOCH_PATTERN = r'Epoch (\d+)/\d+ \((\d+) samples\) - Loss: ([\d.]+) - Accuracy: ([\d.]+)%'
+
+def write_config(base_config_path: str, output_path: str, mode: str) -> None:
+    config = configparser.ConfigParser(inline_comment_prefixes=('#',))
+    config.read(base_config_path)
+    config['hyperparameters']['training_mode'] = mode
+    if not config.has_section('optimizer'):
+        config.add_section('optimizer')
+    # Hogwild! only supports plain sgd without accumulation, use the same update rule for both runs
+    config['optimizer']['type'] = 'sgd'
+    config['hyperparameters']['accumulation_steps'] = '1'
+
+    with open(output_path, 'w') as f:
+        for section in config.sections():
+            f.write(f'[{section}]\n')
+            for key, value in config[section].items():
+                f.write(f'{key}={value}\n')
+            f.write('\n')
+
+def run(mode: str, base_config_path: str, dataset_path: str, workdir: str) -> Dict[str, float]:
+    config_path = os.path.join(workdir, f'{mode}.conf')
+    write_config(base_config_path, config_path, mode)
+    subprocess.run([GENERATOR, config_path, '1'], cwd=workdir, check=True, stdout=subprocess.DEVNULL)
+    network_path = os.path.join(workdir, f'{mode}_1.nn')
+
+    start = time.perf_counter()
+    process = subprocess.run([ANALYZER, '--train', network_path, dataset_path],
+                             capture_output=True, text=True)
+    elapsed = time.perf_counter() - start
+    if process.returncode != 0:
+        print(f"{mode}: training failed\n{process.stderr}", file=sys.stderr)
+        sys.exit(1)
+
+    samples = 0
+    loss = accuracy = 0.0
+    for line in process.stdout.splitlines():
+        match = re.match(EPOCH_PATTERN, line.strip())
+        if match:
+            samples += int(match.group(2))
+            loss = float(match.group(3))
+            accuracy = float(match.group(4))
+    return {'seconds': elapsed, 'samples_per_sec': samples / elapsed, 'loss': loss, 'accuracy': accuracy}
+
+def main() -> None:
+    if len(sys.argv) != 3:
+        print(f"Usage: {sys.argv[0]} CONFIG DATASET", file=sys.stderr)
+        sys.exit(84)
+    base_config_path = os.path.abspath(sys.argv[1])
+    dataset_path = os.path.abspath(sys.argv[2])
+
+    with tempfile.TemporaryDirectory() as workdir:
+        results = {mode: run(mode, base_config_path, dataset_path, workdir) for mode in ('sync', 'hogwild')}
+
+    print(f"{'Mode':<8} | {'Time (s)':>9} | {'Samples/s':>10} | {'Loss':>7} | {'Accuracy':>8}")
+    print('-' * 55)
+    for mode, result in results.items():
+        print(f"{mode:<8} | {result['seconds']:>9.2f} | {result['samples_per_sec']:>10.1f} | "
+              f"{result['loss']:>7.4f} | {result['accuracy']:>7.2f}%")
+    speedup = results['hogwild']['samples_per_sec'] / results['sync']['samples_per_sec']
+    print(f"\nHogwild! speedup: {speedup:.2f}x")
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+import configparser
+import os
+import re
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+from typing import Dict, List
+
+ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__), '..'))
+GENERATOR = os.path.join(ROOT, 'my_torch_generator')
+ANALYZER = os.path.join(ROOT, 'my_torch_analyzer')
+EPOCH_PATTERN = r'Epoch (\d+)/\d+ \((\d+) samples\) - Loss: ([\d.]+) - Accuracy: ([\d.]+)%'
+DEFAULT_SEGMENTS = [0, 1, 2, 4, 8]
+SEED = '42'
+POLL_INTERVAL = 0.02
+
+def write_config(base_config_path: str, output_path: str, segment: int) -> None:
+    config = configparser.ConfigParser(inline_comment_prefixes=('#',))
+    config.read(base_config_path)
+    config['hyperparameters']['recompute_segment'] = str(segment)
+
+    with open(output_path, 'w') as f:
+        for section in config.sections():
+            f.write(f'[{section}]\n')
+            for key, value in config[section].items():
+                f.write(f'{key}={value}\n')
+            f.write('\n')
+
+def resident_kb(pid: int) -> int:
+    try:
+        with open(f'/proc/{pid}/status') as status:
+            for line in status:
+                if line.startswith('VmRSS:'):
+                    return int(line.split()[1])
+    except OSError:
+        pass
+    return 0
+
+def run(segment: int, base_config_path: str, dataset_path: str, workdir: str) -> Dict[str, float]:
+    name = f'segment{segment}'
+    config_path = os.path.join(workdir, f'{name}.conf')
+    write_config(base_config_path, config_path, segment)
+    subprocess.run([GENERATOR, config_path, '1'], cwd=workdir, check=True, stdout=subprocess.DEVNULL)
+    network_path = os.path.join(workdir, f'{name}_1.nn')
+
+    # The resident memory is sampled during the run: the peak also covers loading the network, the median
+    # follows the training loop
+    log_path = os.path.join(workdir, f'{name}.log')
+    rss: List[int] = []
+    start = time.perf_counter()
+    with open(log_path, 'w') as log:
+        process = subprocess.Popen([ANALYZER, '--train', '--seed', SEED, network_path, dataset_path],
+                                   stdout=log, stderr=subprocess.DEVNULL)
+        while process.poll() is None:
+            rss.append(resident_kb(process.pid))
+            time.sleep(POLL_INTERVAL)
+    elapsed = time.perf_counter() - start
+    if process.returncode != 0:
+        print(f"Segment {segment}: training failed", file=sys.stderr)
+        sys.exit(1)
+    with open(log_path) as log:
+        output = log.read()
+    rss = [value for value in rss if value > 0] or [0]
+
+    samples = 0
+    accuracy = 0.0
+    for line in output.splitlines():
+        match = re.match(EPOCH_PATTERN, line.strip())
+        if match:
+            samples += int(match.group(2))
+            accuracy = float(match.group(4))
+    return {'seconds': elapsed, 'samples_per_sec': samples / elapsed, 'peak_mb': max(rss) / 1024,
+            'median_mb': statistics.median(rss) / 1024, 'accuracy': accuracy}
+
+def main() -> None:
+    if len(sys.argv) < 3:
+        print(f"Usage: {sys.argv[0]} CONFIG DATASET [SEGMENT...]", file=sys.stderr)
+        sys.exit(84)
+    base_config_path = os.path.abspath(sys.argv[1])
+    dataset_path = os.path.abspath(sys.argv[2])
+    segments: List[int] = [int(arg) for arg in sys.argv[3:]] or DEFAULT_SEGMENTS
+
+    with tempfile.TemporaryDirectory() as workdir:
+        results = {segment: run(segment, base_config_path, dataset_path, workdir) for segment in segments}
+
+    print(f"{'Segment':>7} | {'Peak RSS (MB)':>13} | {'Median RSS (MB)':>15} | {'Time (s)':>9} | "
+          f"{'Samples/s':>10} | {'Accuracy':>8}")
+    print('-' * 78)
+    for segment, result in results.items():
+        label = 'off' if segment == 0 else str(segment)
+        print(f"{label:>7} | {result['peak_mb']:>13.1f} | {result['median_mb']:>15.1f} | {result['seconds']:>9.2f} | "
+              f"{result['samples_per_sec']:>10.1f} | {result['accuracy']:>7.2f}%")
+
+if __name__ == "__main__":
+    main()
@@ -1,4 +1,5 @@
 #!/usr/bin/env python3
+import argparse
 import json
 import numpy as np
 import matplotlib.pyplot as plt
@@ -118,7 +119,71 @@ def create_parameter_violin_plots(df: pd.DataFrame, save_dir: Path):
         plt.savefig(save_dir / f'{param}_violin.png', dpi=300, bbox_inches='tight')
         plt.close()
 
+def load_training_telemetry(file_path: str) -> pd.DataFrame:
+    """Per-epoch metrics written by `my_torch_analyzer --train --telemetry FILE`, one JSON object per line."""
+    with open(file_path, 'r') as f:
+        records = [json.loads(line) for line in f if line.strip()]
+    return pd.json_normalize(records)
+
+def plot_training_throughput(df: pd.DataFrame, save_dir: Path):
+    fig, ax = plt.subplots(figsize=(12, 6))
+    ax.plot(df['epoch'], df['samples_per_sec'], 'o-', label='Samples/s')
+    ax.set_xlabel('Epoch')
+    ax.set_ylabel('Samples/s')
+    gflops_ax = ax.twinx()
+    gflops_ax.plot(df['epoch'], df['gflops'], 's--', color='tab:red', label='GFLOP/s')
+    gflops_ax.set_ylabel('GFLOP/s')
+    lines = ax.get_legend_handles_labels()
+    gflops_lines = gflops_ax.get_legend_handles_labels()
+    ax.legend(lines[0] + gflops_lines[0], lines[1] + gflops_lines[1], loc='lower right')
+    ax.set_title('Training Throughput', pad=20)
+    ax.grid(True, alpha=0.3)
+    fig.tight_layout()
+    fig.savefig(save_dir / 'training_throughput.png', dpi=300, bbox_inches='tight')
+    plt.close(fig)
+
+def plot_training_time_split(df: pd.DataFrame, save_dir: Path):
+    time_cols = [col for col in df.columns if col.startswith('time.')]
+    if not time_cols:
+        return
+
+    plt.figure(figsize=(12, 6))
+    plt.stackplot(df['epoch'], [df[col] for col in time_cols], labels=[col[len('time.'):] for col in time_cols],
+                  alpha=0.8)
+    plt.xlabel('Epoch')
+    plt.ylabel('Seconds')
+    plt.title('Epoch Time Split', pad=20)
+    plt.legend(bbox_to_anchor=(1.05, 1), loc='upper left')
+    plt.grid(True, alpha=0.3)
+    plt.tight_layout()
+    plt.savefig(save_dir / 'training_time_split.png', dpi=300, bbox_inches='tight')
+    plt.close()
+
+def plot_training_utilization(df: pd.DataFrame, save_dir: Path):
+    fig, ax = plt.subplots(figsize=(12, 6))
+    ax.plot(df['epoch'], df['thread_utilization'] * 100, 'o-', label='Thread utilization (%)')
+    ax.set_xlabel('Epoch')
+    ax.set_ylabel('Busy threads (%)')
+    ax.set_ylim(0, 105)
+    alloc_ax = ax.twinx()
+    alloc_ax.plot(df['epoch'], df['allocations'], 's--', color='tab:green', label='Allocations')
+    alloc_ax.set_ylabel('Allocations per epoch')
+    lines = ax.get_legend_handles_labels()
+    alloc_lines = alloc_ax.get_legend_handles_labels()
+    ax.legend(lines[0] + alloc_lines[0], lines[1] + alloc_lines[1], loc='lower right')
+    ax.set_title('Thread Utilization and Allocations', pad=20)
+    ax.grid(True, alpha=0.3)
+    fig.tight_layout()
+    fig.savefig(save_dir / 'training_utilization.png', dpi=300, bbox_inches='tight')
+    plt.close(fig)
+
 def main():
+    parser = argparse.ArgumentParser(description='Plots hyperparameter optimization reports and training telemetry')
+    parser.add_argument('--report', default='hyperparameter_optimization_report.json',
+                        help='hyperparameter optimization report (skipped when missing)')
+    parser.add_argument('--telemetry', help='per-epoch JSONL file written by my_torch_analyzer --telemetry')
+    args = parser.parse_args()
+
     plt.style.use('tableau-colorblind10')
 
     sns.set_theme(style="whitegrid")
@@ -127,29 +192,42 @@ def main():
     save_dir = Path('optimization_plots')
     save_dir.mkdir(exist_ok=True)
 
-    report = load_optimization_report()
-    df = create_trial_dataframe(report)
-
     # Create all plots
     print("📊 Creating visualization plots...")
 
-    print("  • Plotting accuracy history")
-    plot_accuracy_history(df, save_dir)
+    if Path(args.report).exists() or not args.telemetry:
+        report = load_optimization_report(args.report)
+        df = create_trial_dataframe(report)
+
+        print("  • Plotting accuracy history")
+        plot_accuracy_history(df, save_dir)
+
+        print("  • Creating parameter correlation heatmap")
+        plot_parameter_heatmap(df, save_dir)
+
+        print("  • Plotting parameter importance")
+        plot_parameter_importance(report, save_dir)
+
+        print("  • Plotting layer size distribution")
+        plot_layer_size_distribution(df, save_dir)
+
+        print("  • Visualizing best architectures")
+        plot_best_architectures(df, save_dir)
 
-    print("  • Creating parameter correlation heatmap")
-    plot_parameter_heatmap(df, save_dir)
+        print("  • Creating parameter violin plots")
+        create_parameter_violin_plots(df, save_dir)
 
-    print("  • Plotting parameter importance")
-    plot_parameter_importance(report, save_dir)
+    if args.telemetry:
+        telemetry = load_training_telemetry(args.telemetry)
 
-    print("  • Plotting layer size distribution")
-    plot_layer_size_distribution(df, save_dir)
+        print("  • Plotting training throughput")
+        plot_training_throughput(telemetry, save_dir)
 
-    print("  • Visualizing best architectures")
-    plot_best_architectures(df, save_dir)
+        print("  • Plotting epoch time split")
+        plot_training_time_split(telemetry, save_dir)
 
-    print("  • Creating parameter violin plots")
-    create_parameter_violin_plots(df, save_dir)
+        print("  • Plotting thread utilization and allocations")
+        plot_training_utilization(telemetry, save_dir)
 
     print(f"\n✨ All plots have been saved to the '{save_dir}' directory")
     print("\nGenerated plots:")
@@ -5,36 +5,47 @@
 ** main
 */
 
+#include <algorithm>
+#include <iomanip>
 #include <iostream>
 #include <vector>
 #include "ArgParser.hpp"
 #include "ChessboardParser.hpp"
+#include "Profiler/Profiler.hpp"
+#include "Tensor/Int8Kernels.hpp"
+#include "Tensor/Memory.hpp"
+#include "nn/QuantizedSequential.hpp"
 #include "nn/Sequential.hpp"
+#include "training/PopulationTraining.hpp"
 #include "training/chessTraining.hpp"
 #include "utils/NetworkConfig.hpp"
 #include "utils/NetworkLoader.hpp"
+#include "utils/NetworkSaver.hpp"
+#include "utils/Quantizer.hpp"
 
+static const std::vector<std::string> CLASSES = {
+    "Checkmate White", "Checkmate Black", "Check White", "Check Black", "Stalemate", "Nothing"
+};
+
+template <typename T>
 std::vector<std::string> predictPositions(
-    lava::nn::Sequential<double> &model,
+    lava::nn::Sequential<T> &model,
     const std::vector<ChessboardParser::ChessboardData> &boards
 )
 {
     std::vector<std::string> predictions;
-    const std::vector<std::string> classes = {
-        "Checkmate White", "Checkmate Black", "Check White", "Check Black", "Stalemate", "Nothing"
-    };
 
     for (const auto &board : boards) {
         std::vector<int> inputShape = {1, static_cast<int>(board.boardData.size())};
         std::vector<int> strides = {static_cast<int>(board.boardData.size()), 1}; // Row-major strides
-        lava::TensorArray<double> tensorArray(inputShape, strides);
-        tensorArray.datas() = board.boardData;
-        lava::Tensor<double> input(tensorArray);
+        lava::TensorArray<T> tensorArray(inputShape, strides, lava::TensorArray<T>::InitType::UNINITIALIZED);
+        std::copy(board.boardData.begin(), board.boardData.end(), tensorArray.datas().begin());
+        lava::Tensor<T> input(std::move(tensorArray));
         auto output = model.forward(input);
 
         size_t predictedClass = 0;
         const auto &outputData = output.tensor().datas();
-        double maxProb = outputData[0];
+        T maxProb = outputData[0];
         for (size_t i = 1; i < outputData.size(); i++) {
             if (outputData[i] > maxProb) {
                 maxProb = outputData[i];
@@ -42,44 +53,163 @@ std::vector<std::string> predictPositions(
             }
         }
 
-        predictions.push_back(classes[predictedClass]);
+        predictions.push_back(CLASSES[predictedClass]);
     }
 
     return predictions;
 }
 
+std::vector<std::string> predictQuantizedPositions(
+    const lava::nn::QuantizedSequential &model,
+    const std::vector<ChessboardParser::ChessboardData> &boards
+)
+{
+    std::vector<std::string> predictions;
+
+    for (const auto &board : boards) {
+        auto logits = model.forward(board.boardData);
+        predictions.push_back(CLASSES[std::distance(logits.begin(), std::max_element(logits.begin(), logits.end()))]);
+    }
+    return predictions;
+}
+
+template <typename T>
+void quantize(const ArgParser::AnalyzerArgs &args)
+{
+    auto model = lava::NetworkLoader::loadNetwork<T>(args.loadFile, true);
+    auto calibration = ChessboardParser::parseChessboardFile(args.inputFile);
+    auto quantized = lava::Quantizer::quantize(*model, calibration);
+    lava::NetworkSaver::saveQuantizedNetwork(quantized, args.saveFile, lava::NetworkLoader::getLastLoadedConfig());
+
+    auto tests = ChessboardParser::parseChessboardFile(args.testFile);
+    auto report = lava::Quantizer::evaluate(*model, quantized, tests);
+    auto percent = [](size_t count, size_t total) { return total ? 100.0 * count / total : 0.0; };
+
+    std::cout << "Quantized network saved to " << args.saveFile << " (int8 kernel: "
+              << lava::kernels::int8KernelName(lava::kernels::int8Kernel()) << ")" << std::endl;
+    std::cout << "Calibration positions: " << calibration.size() << std::endl;
+    std::cout << "Test positions: " << report.samples << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Agreement with the float model: " << percent(report.agreements, report.samples) << "%" << std::endl;
+    if (report.labeled > 0) {
+        std::cout << "Float accuracy: " << percent(report.floatCorrect, report.labeled) << "%" << std::endl;
+        std::cout << "Int8 accuracy: " << percent(report.int8Correct, report.labeled) << "%" << std::endl;
+    }
+}
+
+template <typename T>
+void trainPopulation(const ArgParser::AnalyzerArgs &args)
+{
+    std::vector<lava::train::Member<T>> population;
+    for (const auto &file : args.populationFiles) {
+        if (lava::NetworkLoader::readDType(file) != lava::format::dtypeOf<T>()) {
+            throw std::runtime_error("The networks of a population must have the same data type: " + file);
+        }
+        auto network = lava::NetworkLoader::loadNetwork<T>(file);
+        population.push_back({file, network, lava::NetworkLoader::getLastLoadedConfig()});
+    }
+    const auto &config = population.front().config;
+
+    lava::train::PopulationOptions options;
+    options.interval = args.populationInterval;
+    options.fraction = args.populationFraction;
+    options.validationSplit = config.validation().split > 0 ? config.validation().split : options.validationSplit;
+    options.seed = args.seed;
+    options.saveFile = args.saveFile;
+    lava::train::populationTrain(population, ChessboardParser::parseChessboardFile(args.inputFile), options);
+}
+
+template <typename T>
+void run(const ArgParser::AnalyzerArgs &args)
+{
+    if (args.isQuantizeMode) {
+        quantize<T>(args);
+        return;
+    }
+    if (args.isPopulationMode) {
+        trainPopulation<T>(args);
+        return;
+    }
+
+    auto model = lava::NetworkLoader::loadNetwork<T>(args.loadFile, args.isPredictMode);
+
+    if (args.isConvertMode) {
+        lava::NetworkSaver::saveNetwork(model, args.saveFile);
+        std::cout << "Network converted to " << args.convertType << " in " << args.saveFile << std::endl;
+        return;
+    }
+
+    auto boards = ChessboardParser::parseChessboardFile(args.inputFile);
+
+    if (args.isPredictMode) {
+        auto predictions = predictPositions(*model, boards);
+        for (const auto &pred : predictions) {
+            std::cout << pred << std::endl;
+        }
+        // On the error output, the standard output only holds the predictions
+        lava::memory::printReport(std::cerr, "Memory after prediction");
+    } else if (args.isTrainMode) {
+        auto config = lava::train::makeTrainingConfig(lava::NetworkLoader::getLastLoadedConfig());
+        config.loadFile = args.loadFile;
+        config.shouldSave = !args.saveFile.empty();
+        config.saveFile = args.saveFile.empty() ? args.loadFile : args.saveFile;
+        config.seed = args.seed;
+        config.resume = args.resume;
+        config.telemetryFile = args.telemetryFile;
+        config.distributed.rank = args.rank;
+        config.distributed.worldSize = args.worldSize;
+        config.distributed.transport = args.transport;
+        config.distributed.address = args.distAddress;
+
+        lava::train::chessTrain(*model, boards, config);
+    }
+}
+
+/**
+ *  @brief Writes the Chrome trace of the run and prints the per-op table, when --profile was given.
+ */
+static void writeProfile(const ArgParser::AnalyzerArgs &args)
+{
+    if (args.profileFile.empty()) {
+        return;
+    }
+    lava::profiler::disable();
+    lava::profiler::writeChromeTrace(args.profileFile);
+    lava::profiler::printSummary(std::cerr);
+    std::cerr << "Chrome trace written to " << args.profileFile << std::endl;
+}
+
 int main(int argc, char *argv[])
 {
     try {
         auto args = ArgParser::parseAnalyzerArgs(argc, argv);
-        auto model = lava::NetworkLoader::loadNetwork(args.loadFile);
-        auto boards = ChessboardParser::parseChessboardFile(args.inputFile);
+        if (!args.profileFile.empty()) {
+            lava::profiler::enable();
+        }
 
-        if (args.isPredictMode) {
-            auto predictions = predictPositions(*model, boards);
-            for (const auto &pred : predictions) {
+        if (!args.isConvertMode && lava::NetworkLoader::readDType(args.loadFile) == lava::format::DType::INT8) {
+            if (!args.isPredictMode) {
+                throw std::runtime_error("Quantized networks can only be used with --predict");
+            }
+            auto model = lava::NetworkLoader::loadQuantizedNetwork(args.loadFile);
+            auto boards = ChessboardParser::parseChessboardFile(args.inputFile);
+            for (const auto &pred : predictQuantizedPositions(model, boards)) {
                 std::cout << pred << std::endl;
             }
-        } else if (args.isTrainMode) {
-            lava::train::TrainingConfig config;
-            config.shouldSave = !args.saveFile.empty();
-            config.saveFile = args.saveFile.empty() ? args.loadFile : args.saveFile;
-
-            auto networkConfig = lava::NetworkLoader::getLastLoadedConfig();
-            config.learningRate = networkConfig.hyperparameters().learningRate;
-            config.batchSize = networkConfig.hyperparameters().batchSize;
-            config.epochs = networkConfig.hyperparameters().epochs;
-            config.samplesPerEpoch = networkConfig.hyperparameters().samplesPerEpoch;
-
-            // Load learning rate scheduler configuration
-            const auto &lrScheduler = networkConfig.lrScheduler();
-            config.schedulerType = lrScheduler.type;
-            config.decayRate = lrScheduler.decayRate;
-            config.decaySteps = lrScheduler.decaySteps;
-            config.minLearningRate = lrScheduler.minLR;
-
-            lava::train::chessTrain(*model, boards, config);
+            writeProfile(args);
+            return 0;
+        }
+
+        // The network runs with the data type of its file, unless it is being converted
+        bool useFloat = args.isConvertMode
+            ? args.convertType == "float32"
+            : lava::NetworkLoader::readDType(args.loadFile) == lava::format::DType::FLOAT32;
+        if (useFloat) {
+            run<float>(args);
+        } else {
+            run<double>(args);
         }
+        writeProfile(args);
         return 0;
     } catch (const std::exception &e) {
         std::cerr << "Error: " << e.what() << std::endl;
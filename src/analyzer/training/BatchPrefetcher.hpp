@@ -0,0 +1,232 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** BatchPrefetcher
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "ChessboardParser.hpp"
+#include "Profiler/Profiler.hpp"
+#include "Tensor/Memory.hpp"
+#include "Tensor/Storage.hpp"
+#include "training/chessTraining.hpp"
+
+namespace lava::train {
+
+/**
+ *  @tparam Type of the network inputs.
+ *
+ *  @brief Assembles the minibatches of an epoch on a background thread, one batch ahead of the training.
+ *
+ *  Two batch buffers are allocated once and reused (double buffering): while the training computes on
+ *  one of them, the next batch is converted to @tparam T in the other. The label indices are computed
+ *  once for the whole dataset.
+ *
+ *  In a data-parallel training, each batch only holds the share of the rank, the batch count of an
+ *  epoch being the same on every rank (a share can be empty).
+ *
+ *  NOTE: A batch returned by next() stays valid until the following call to next().
+ */
+template <typename T>
+class BatchPrefetcher {
+    public:
+    struct Batch {
+        Storage<T> inputs; /** size rows of inputSize values, 64-byte aligned */
+        std::vector<size_t> labels;
+        size_t size{0};
+        size_t inputSize{0};
+
+        const T *input(size_t idx) const
+        {
+            return inputs.data() + idx * inputSize;
+        }
+
+        T *input(size_t idx)
+        {
+            return inputs.data() + idx * inputSize;
+        }
+    };
+
+    struct Stats {
+        size_t batches{0};
+        size_t stalls{0}; /** Batches that were not ready when the training asked for them */
+        double waitSeconds{0.0}; /** Time the training spent waiting on data */
+    };
+
+    BatchPrefetcher(
+        const std::vector<ChessboardParser::ChessboardData> &datas,
+        size_t batchSize,
+        size_t rank = 0,
+        size_t worldSize = 1
+    )
+        : _datas(datas), _batchSize(batchSize), _rank(rank), _worldSize(worldSize)
+    {
+        _inputSize = datas.empty() ? 0 : datas[0].boardData.size();
+        _labels.reserve(datas.size());
+        for (const auto &board : datas) {
+            if (board.boardData.size() != _inputSize) {
+                throw std::runtime_error("All training positions must have the same input size");
+            }
+            _labels.push_back(getLabelIndex(board.expectedOutput));
+        }
+        memory::Scope scope(memory::Category::BATCHES);
+        for (auto &slot : _slots) {
+            slot.batch.inputs = Storage<T>(_batchSize * _inputSize);
+            slot.batch.labels.resize(_batchSize);
+            slot.batch.inputSize = _inputSize;
+        }
+    }
+
+    BatchPrefetcher(const BatchPrefetcher &) = delete;
+    BatchPrefetcher &operator=(const BatchPrefetcher &) = delete;
+
+    ~BatchPrefetcher()
+    {
+        stop();
+    }
+
+    /**
+     *  @brief Starts assembling the batches of @param indices, in order, and resets the stats.
+     *
+     *  NOTE: Batches of the previous epoch that were not consumed are dropped.
+     */
+    void startEpoch(std::vector<size_t> indices)
+    {
+        stop();
+        _indices = std::move(indices);
+        _batchCount = (_indices.size() + _batchSize - 1) / _batchSize;
+        _consumed = 0;
+        _stopping = false;
+        _stats = Stats{};
+        for (auto &slot : _slots) {
+            slot.state = SlotState::FREE;
+        }
+        _worker = std::thread(&BatchPrefetcher::produce, this);
+    }
+
+    /**
+     *  @brief Releases the previous batch and returns the next one, waiting for it if needed.
+     *
+     *  @return nullptr once every batch of the epoch was returned.
+     */
+    Batch *next()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        for (auto &slot : _slots) {
+            if (slot.state == SlotState::IN_USE) {
+                slot.state = SlotState::FREE;
+            }
+        }
+        _condition.notify_all();
+        if (_consumed == _batchCount) {
+            return nullptr;
+        }
+
+        auto &slot = _slots[_consumed % _slots.size()];
+        if (slot.state != SlotState::READY) {
+            profiler::Scope profile("BatchPrefetcher::wait");
+            auto start = std::chrono::steady_clock::now();
+            _condition.wait(lock, [&slot] { return slot.state == SlotState::READY; });
+            _stats.waitSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            _stats.stalls++;
+        }
+        slot.state = SlotState::IN_USE;
+        _stats.batches++;
+        _consumed++;
+        return &slot.batch;
+    }
+
+    Stats stats() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _stats;
+    }
+
+    private:
+    enum class SlotState {
+        FREE,
+        READY,
+        IN_USE
+    };
+
+    struct Slot {
+        Batch batch;
+        SlotState state{SlotState::FREE};
+    };
+
+    void produce()
+    {
+        for (size_t b = 0; b < _batchCount; b++) {
+            auto &slot = _slots[b % _slots.size()];
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _condition.wait(lock, [this, &slot] { return _stopping || slot.state == SlotState::FREE; });
+                if (_stopping) {
+                    return;
+                }
+            }
+
+            // The slot is free: only this thread touches it until it is marked ready
+            profiler::Scope profile("BatchPrefetcher::fill");
+            auto &batch = slot.batch;
+            size_t first = b * _batchSize;
+            size_t globalSize = std::min(_batchSize, _indices.size() - first);
+            first += globalSize * _rank / _worldSize;
+            batch.size = globalSize * (_rank + 1) / _worldSize - globalSize * _rank / _worldSize;
+            for (size_t j = 0; j < batch.size; j++) {
+                size_t idx = _indices[first + j];
+                const auto &board = _datas[idx].boardData;
+                std::transform(board.begin(), board.end(), batch.input(j), [](double v) { return static_cast<T>(v); });
+                batch.labels[j] = _labels[idx];
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                slot.state = SlotState::READY;
+            }
+            _condition.notify_all();
+        }
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+        _condition.notify_all();
+        if (_worker.joinable()) {
+            _worker.join();
+        }
+    }
+
+    const std::vector<ChessboardParser::ChessboardData> &_datas;
+    size_t _batchSize;
+    size_t _rank;
+    size_t _worldSize;
+    size_t _inputSize{0};
+    std::vector<size_t> _labels; /** Label index of every sample of the dataset */
+
+    std::array<Slot, 2> _slots;
+    std::vector<size_t> _indices;
+    size_t _batchCount{0};
+    size_t _consumed{0};
+    bool _stopping{false};
+    Stats _stats;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _condition;
+    std::thread _worker;
+};
+
+} // namespace lava::train
@@ -0,0 +1,79 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** Communicator
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "training/Transport.hpp"
+
+namespace lava::train {
+
+/**
+ *  @brief Collective operations of a data-parallel training, over the ring of a Transport.
+ */
+class Communicator {
+    public:
+    explicit Communicator(std::unique_ptr<Transport> transport) : _transport(std::move(transport)) {}
+
+    size_t rank() const
+    {
+        return _transport->rank();
+    }
+
+    size_t worldSize() const
+    {
+        return _transport->worldSize();
+    }
+
+    /**
+     *  @brief Replaces @param datas by its element-wise sum over every rank (ring all-reduce).
+     *
+     *  The buffer is cut in worldSize() chunks. A reduce-scatter of worldSize() - 1 steps leaves each rank
+     *  with the sum of one chunk, then an all-gather of worldSize() - 1 steps copies the sums to every rank.
+     *  Each rank sends and receives 2 * (worldSize() - 1) / worldSize() times the buffer, whatever the
+     *  number of ranks.
+     *
+     *  NOTE: Every rank ends with bit-identical values, the sum of a chunk being computed once.
+     */
+    template <typename T>
+    void allReduce(T *datas, size_t count)
+    {
+        const size_t world = worldSize();
+        const size_t me = rank();
+        auto begin = [&](size_t chunk) { return chunk * count / world; };
+        auto size = [&](size_t chunk) { return begin(chunk + 1) - begin(chunk); };
+
+        // The chunks hold count / world or count / world + 1 elements
+        _scratch.resize((count / world + 1) * sizeof(T));
+        T *incoming = reinterpret_cast<T *>(_scratch.data());
+
+        for (size_t step = 0; step + 1 < world; step++) {
+            size_t sent = (me + world - step) % world;
+            size_t received = (me + world - step - 1) % world;
+            _transport->exchange(datas + begin(sent), size(sent) * sizeof(T), incoming, size(received) * sizeof(T));
+            T *target = datas + begin(received);
+            for (size_t i = 0; i < size(received); i++) {
+                target[i] += incoming[i];
+            }
+        }
+        for (size_t step = 0; step + 1 < world; step++) {
+            size_t sent = (me + 1 + world - step) % world;
+            size_t received = (me + world - step) % world;
+            _transport->exchange(
+                datas + begin(sent), size(sent) * sizeof(T), datas + begin(received), size(received) * sizeof(T)
+            );
+        }
+    }
+
+    private:
+    std::unique_ptr<Transport> _transport;
+    std::vector<std::byte> _scratch; /** Received chunk, aligned for any arithmetic type by operator new */
+};
+
+} // namespace lava::train
@@ -0,0 +1,267 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** PopulationTraining
+*/
+
+#include "training/PopulationTraining.hpp"
+
+#include <algorithm>
+#include <barrier>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include "training/Validator.hpp"
+#include "training/chessTraining.hpp"
+#include "utils/NetworkSaver.hpp"
+
+namespace lava::train {
+
+namespace {
+
+constexpr double PERTURBATION = 1.2;
+
+/**
+ *  @brief Ranking and exploration state of a network, written by its training thread before the
+ *         barrier and by the exploit step during it.
+ */
+template <typename T>
+struct MemberState {
+    std::unique_ptr<Validator<T>> validator;
+    size_t epoch{0};
+    double accuracy{0.0};
+    double loss{0.0};
+    double learningRate{0.0};
+    double decayRate{0.0};
+    bool exploited{false}; /** Took the weights of a better network, applies learningRate and decayRate */
+    size_t exploits{0};
+    bool done{false};
+    std::string error;
+};
+
+template <typename T>
+void checkArchitectures(const std::vector<Member<T>> &population)
+{
+    auto shapes = [](const Member<T> &member) {
+        std::vector<std::vector<int>> result;
+        for (const auto *tensor : member.network->parameters().tensors()) {
+            result.push_back(tensor->shape());
+        }
+        return result;
+    };
+    for (const auto &member : population) {
+        if (shapes(member) != shapes(population.front())) {
+            throw std::runtime_error(
+                "Population based training needs networks of the same architecture: " + member.name + " differs from "
+                + population.front().name
+            );
+        }
+    }
+}
+
+/**
+ *  @brief 1 - decayRate is perturbed, so the decay rate stays in (0, 1].
+ */
+double perturbDecay(double decayRate, double factor)
+{
+    return std::clamp(1.0 - (1.0 - decayRate) * factor, std::numeric_limits<double>::min(), 1.0);
+}
+
+} // namespace
+
+template <typename T>
+void populationTrain(
+    std::vector<Member<T>> &population,
+    const std::vector<ChessboardParser::ChessboardData> &datas,
+    const PopulationOptions &options
+)
+{
+    const size_t size = population.size();
+    if (size < 2) {
+        throw std::runtime_error("Population based training needs at least two networks");
+    }
+    if (options.interval == 0 || options.fraction <= 0 || options.fraction > 0.5) {
+        throw std::runtime_error("Population based training needs an interval and a fraction in (0, 0.5]");
+    }
+    checkArchitectures(population);
+    std::mt19937_64 rng(options.seed.value_or(std::random_device{}()));
+
+    // Every network trains on the same positions and is ranked on the same held out ones
+    std::vector<size_t> indices(datas.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    std::shuffle(indices.begin(), indices.end(), rng);
+    size_t count = static_cast<size_t>(options.validationSplit * datas.size());
+    if (count == 0 || count == datas.size()) {
+        throw std::runtime_error("The validation split must leave positions for training and validation");
+    }
+    std::vector<ChessboardParser::ChessboardData> trainDatas;
+    std::vector<ChessboardParser::ChessboardData> validationDatas;
+    for (size_t i = 0; i < indices.size(); i++) {
+        (i < count ? validationDatas : trainDatas).push_back(datas[indices[i]]);
+    }
+    std::vector<size_t> validationLabels;
+    for (const auto &board : validationDatas) {
+        validationLabels.push_back(getLabelIndex(board.expectedOutput));
+    }
+    std::vector<size_t> validationIndices(validationDatas.size());
+    std::iota(validationIndices.begin(), validationIndices.end(), 0);
+
+    const size_t epochs = population.front().config.hyperparameters().epochs;
+    const size_t threads = std::max<size_t>(1, std::max(1u, std::thread::hardware_concurrency()) / size);
+    std::vector<MemberState<T>> states(size);
+    for (auto &state : states) {
+        state.validator = std::make_unique<Validator<T>>(validationDatas, validationIndices, validationLabels);
+    }
+
+    std::cout << "Population based training: " << size << " networks on " << threads << " threads each, "
+              << trainDatas.size() << " training and " << validationDatas.size() << " validation positions"
+              << std::endl;
+    std::cout << "Every " << options.interval << " epochs, the worst " << options.fraction * 100
+              << "% take the weights of the best " << options.fraction * 100 << "%" << std::endl;
+
+    // Runs on the last network reaching the barrier, while the others wait: no weights are in use
+    auto exploit = [&]() noexcept {
+        std::vector<size_t> ranked;
+        for (size_t i = 0; i < size; i++) {
+            if (!states[i].done) {
+                ranked.push_back(i);
+            }
+        }
+        if (ranked.empty()) {
+            return;
+        }
+        std::sort(ranked.begin(), ranked.end(), [&](size_t a, size_t b) {
+            return states[a].accuracy != states[b].accuracy ? states[a].accuracy > states[b].accuracy
+                                                            : states[a].loss < states[b].loss;
+        });
+        const size_t epoch = states[ranked.front()].epoch;
+        std::cout << "Epoch " << epoch << "/" << epochs << " - Validation accuracy:" << std::fixed
+                  << std::setprecision(2);
+        for (size_t i : ranked) {
+            std::cout << " " << population[i].name << " " << states[i].accuracy * 100 << "%";
+        }
+        std::cout << std::endl;
+        if (epoch >= epochs) {
+            return;
+        }
+
+        const size_t replaced = std::min(
+            ranked.size() / 2, std::max<size_t>(1, static_cast<size_t>(options.fraction * ranked.size()))
+        );
+        std::bernoulli_distribution up(0.5);
+        for (size_t k = 0; k < replaced; k++) {
+            const size_t loserIndex = ranked[ranked.size() - 1 - k];
+            const size_t winnerIndex = ranked[std::uniform_int_distribution<size_t>(0, replaced - 1)(rng)];
+            auto &loser = states[loserIndex];
+            const auto &winner = states[winnerIndex];
+            auto &from = population[winnerIndex].network->parameters();
+            auto &to = population[loserIndex].network->parameters();
+            std::memcpy(to.datas(), from.datas(), from.size() * sizeof(T));
+
+            loser.learningRate = winner.learningRate * (up(rng) ? PERTURBATION : 1 / PERTURBATION);
+            loser.decayRate = perturbDecay(winner.decayRate, up(rng) ? PERTURBATION : 1 / PERTURBATION);
+            loser.exploited = true;
+            loser.exploits++;
+            std::cout << "  " << population[loserIndex].name << " <- "
+                      << population[winnerIndex].name << ": learning rate " << std::scientific << std::setprecision(3)
+                      << loser.learningRate << ", decay rate " << std::fixed << std::setprecision(4)
+                      << loser.decayRate << std::endl;
+        }
+    };
+    std::barrier sync(static_cast<std::ptrdiff_t>(size), exploit);
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < size; i++) {
+        workers.emplace_back([&, i, seed = rng()]() {
+            auto &state = states[i];
+            auto &member = population[i];
+            try {
+                auto config = makeTrainingConfig(member.config);
+                config.epochs = epochs;
+                config.validation = ValidationOptions{};
+                config.shouldSave = false;
+                config.seed = seed;
+                config.threads = threads;
+                config.quiet = true;
+                config.onEpoch = [&](EpochControl &control) {
+                    if (control.epoch % options.interval != 0 && control.epoch != epochs) {
+                        return true;
+                    }
+                    state.validator->submit(*member.network, control.epoch);
+                    auto result = state.validator->finish();
+                    state.epoch = control.epoch;
+                    state.accuracy = result->accuracy;
+                    state.loss = result->loss;
+                    state.learningRate = control.scheduler.baseLearningRate();
+                    state.decayRate = control.scheduler.decayRate();
+                    state.exploited = false;
+                    sync.arrive_and_wait();
+                    if (state.exploited) {
+                        // The moments of the previous weights do not apply to the copied ones
+                        control.scheduler.setHyperparameters(state.learningRate, state.decayRate);
+                        control.resetOptimizer = true;
+                    }
+                    return true;
+                };
+                chessTrain(*member.network, trainDatas, config);
+            } catch (const std::exception &e) {
+                state.error = e.what();
+            }
+            state.done = true;
+            sync.arrive_and_drop();
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    const MemberState<T> *best = nullptr;
+    size_t bestIndex = 0;
+    for (size_t i = 0; i < size; i++) {
+        if (!states[i].error.empty()) {
+            std::cerr << "Training of " << population[i].name << " failed: " << states[i].error << std::endl;
+        } else if (!best || states[i].accuracy > best->accuracy) {
+            best = &states[i];
+            bestIndex = i;
+        }
+    }
+    if (!best) {
+        throw std::runtime_error("Every network of the population failed to train");
+    }
+    std::cout << "\nBest network: " << population[bestIndex].name << " - Validation accuracy: " << std::fixed
+              << std::setprecision(2) << best->accuracy * 100 << "% - Learning rate: " << std::scientific
+              << std::setprecision(3) << best->learningRate << " - Decay rate: " << std::fixed
+              << std::setprecision(4) << best->decayRate << " - Weights copied " << best->exploits << " times"
+              << std::endl;
+
+    if (!options.saveFile.empty()) {
+        // The saved configuration holds the explored hyperparameters
+        std::ostringstream overrides;
+        overrides << std::setprecision(std::numeric_limits<double>::max_digits10) << "\n[hyperparameters]\n"
+                  << "learning_rate=" << best->learningRate << "\n[lr_scheduler]\ndecay_rate=" << best->decayRate
+                  << "\n";
+        auto config = NetworkConfig::fromString(population[bestIndex].config.toString() + overrides.str());
+        NetworkSaver::saveNetwork(population[bestIndex].network, options.saveFile, config);
+        std::cout << "Best network saved to " << options.saveFile << std::endl;
+    }
+}
+
+template void populationTrain<double>(
+    std::vector<Member<double>> &population,
+    const std::vector<ChessboardParser::ChessboardData> &datas,
+    const PopulationOptions &options
+);
+template void populationTrain<float>(
+    std::vector<Member<float>> &population,
+    const std::vector<ChessboardParser::ChessboardData> &datas,
+    const PopulationOptions &options
+);
+
+} // namespace lava::train
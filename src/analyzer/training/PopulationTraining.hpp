@@ -0,0 +1,59 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** PopulationTraining
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include "ChessboardParser.hpp"
+#include "nn/Sequential.hpp"
+#include "utils/NetworkConfig.hpp"
+
+namespace lava::train {
+
+struct PopulationOptions {
+    size_t interval{5}; /** Epochs between two exploit and explore steps */
+    double fraction{0.25}; /** Worst fraction of the population replaced by copies of the best fraction */
+    double validationSplit{0.1}; /** Fraction of the positions held out to rank the networks */
+    std::optional<uint64_t> seed;
+    std::string saveFile; /** The best network is saved to it, when set */
+};
+
+/**
+ *  @tparam Type of the network weights.
+ *
+ *  @brief A network of the population with the configuration it was loaded with.
+ */
+template <typename T>
+struct Member {
+    std::string name;
+    std::shared_ptr<nn::Sequential<T>> network;
+    NetworkConfig config;
+};
+
+/**
+ *  @brief Population based training: the networks of @param population train side by side on the
+ *         positions @param datas, each with its own configuration and its share of the hardware threads.
+ *
+ *  Every interval epochs, the networks are ranked on the held out positions. Each network of the worst
+ *  fraction takes the weights of one of the best fraction (exploit) and its learning rate and decay rate,
+ *  each multiplied or divided by 1.2 (explore, the decay rate through 1 - decayRate).
+ *
+ *  NOTE: The networks must share their architecture, and train for the epochs of the first one.
+ *        Instantiated for float and double networks.
+ */
+template <typename T>
+void populationTrain(
+    std::vector<Member<T>> &population,
+    const std::vector<ChessboardParser::ChessboardData> &datas,
+    const PopulationOptions &options
+);
+
+} // namespace lava::train
@@ -0,0 +1,292 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** Sampler
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace lava::train {
+
+struct SamplerOptions {
+    std::string type{"shuffle"}; /** shuffle or stratified */
+    /**
+     *  Stratified only: a class is drawn with a probability proportional to its size to the power of balance,
+     *  0 draws every class equally often, 1 follows the dataset distribution.
+     */
+    double balance{0.0};
+};
+
+/**
+ *  @brief Walker's alias table: draws an index with probability proportional to its weight in O(1).
+ *
+ *  Built in O(n) with Vose's method: every bucket holds its own index with probability _probability[i]
+ *  and the index _alias[i] otherwise.
+ */
+class AliasTable {
+    public:
+    explicit AliasTable(const std::vector<double> &weights) : _probability(weights.size()), _alias(weights.size())
+    {
+        const size_t n = weights.size();
+        double total = std::accumulate(weights.begin(), weights.end(), 0.0);
+        if (n == 0 || total <= 0) {
+            throw std::runtime_error("Alias table needs a positive total weight");
+        }
+
+        std::vector<double> scaled(n);
+        std::vector<size_t> small;
+        std::vector<size_t> large;
+        for (size_t i = 0; i < n; i++) {
+            scaled[i] = weights[i] * n / total;
+            (scaled[i] < 1.0 ? small : large).push_back(i);
+        }
+        while (!small.empty() && !large.empty()) {
+            size_t less = small.back();
+            size_t more = large.back();
+            small.pop_back();
+            _probability[less] = scaled[less];
+            _alias[less] = more;
+            scaled[more] -= 1.0 - scaled[less];
+            if (scaled[more] < 1.0) {
+                large.pop_back();
+                small.push_back(more);
+            }
+        }
+        // Left overs are 1 up to rounding errors
+        for (size_t i : large) {
+            _probability[i] = 1.0;
+            _alias[i] = i;
+        }
+        for (size_t i : small) {
+            _probability[i] = 1.0;
+            _alias[i] = i;
+        }
+    }
+
+    template <typename Rng>
+    size_t sample(Rng &rng) const
+    {
+        size_t bucket = std::uniform_int_distribution<size_t>(0, _probability.size() - 1)(rng);
+        return std::uniform_real_distribution<double>(0.0, 1.0)(rng) < _probability[bucket] ? bucket : _alias[bucket];
+    }
+
+    private:
+    std::vector<double> _probability;
+    std::vector<size_t> _alias;
+};
+
+/**
+ *  @brief Chooses the training positions of each epoch, as indices in the dataset.
+ */
+class Sampler {
+    public:
+    virtual ~Sampler() = default;
+
+    /**
+     *  @brief Draws the @param count next positions to train on.
+     */
+    virtual std::vector<size_t> next(size_t count) = 0;
+
+    virtual std::string describe() const = 0;
+
+    /**
+     *  @brief Position of the sampler and state of its random generator, as text.
+     */
+    virtual std::string state() const = 0;
+
+    /**
+     *  @brief Continues from a state(), taken by a sampler built on the same dataset.
+     */
+    virtual void restore(const std::string &state) = 0;
+
+    protected:
+    static void readIndices(std::istream &in, std::vector<size_t> &indices)
+    {
+        size_t count = 0;
+        in >> count;
+        if (!in || count != indices.size()) {
+            throw std::runtime_error("Sampler state does not match the dataset");
+        }
+        for (auto &idx : indices) {
+            in >> idx;
+        }
+    }
+
+    static void writeIndices(std::ostream &out, const std::vector<size_t> &indices)
+    {
+        out << indices.size();
+        for (size_t idx : indices) {
+            out << ' ' << idx;
+        }
+        out << '\n';
+    }
+};
+
+/**
+ *  @brief Shuffles the whole dataset each epoch and keeps its first positions.
+ */
+class ShuffleSampler : public Sampler {
+    public:
+    ShuffleSampler(size_t datasetSize, uint64_t seed) : _indices(datasetSize), _rng(seed)
+    {
+        std::iota(_indices.begin(), _indices.end(), 0);
+    }
+
+    std::vector<size_t> next(size_t count) override
+    {
+        std::shuffle(_indices.begin(), _indices.end(), _rng);
+        return {_indices.begin(), _indices.begin() + std::min(count, _indices.size())};
+    }
+
+    std::string describe() const override
+    {
+        return "shuffle";
+    }
+
+    std::string state() const override
+    {
+        std::ostringstream out;
+        out << _rng << '\n';
+        writeIndices(out, _indices);
+        return out.str();
+    }
+
+    void restore(const std::string &state) override
+    {
+        std::istringstream in(state);
+        in >> _rng;
+        readIndices(in, _indices);
+        if (!in) {
+            throw std::runtime_error("Invalid shuffle sampler state");
+        }
+    }
+
+    private:
+    std::vector<size_t> _indices;
+    std::mt19937 _rng;
+};
+
+/**
+ *  @brief Class-balanced stream of positions: the class of each position is drawn from an alias table,
+ *         then the position is the next one of the shuffled pool of that class.
+ *
+ *  The pools are consumed without replacement and reshuffled once exhausted, independently of the epochs,
+ *  so a rare class is cycled through much faster than the dataset. Drawing a position is O(1).
+ */
+class StratifiedSampler : public Sampler {
+    public:
+    StratifiedSampler(const std::vector<size_t> &labels, double balance, uint64_t seed)
+        : _rng(seed), _balance(balance)
+    {
+        for (size_t i = 0; i < labels.size(); i++) {
+            if (labels[i] >= _pools.size()) {
+                _pools.resize(labels[i] + 1);
+            }
+            _pools[labels[i]].indices.push_back(i);
+        }
+
+        std::vector<double> weights;
+        for (auto &pool : _pools) {
+            double size = static_cast<double>(pool.indices.size());
+            weights.push_back(size > 0 ? std::pow(size, balance) : 0.0);
+            std::shuffle(pool.indices.begin(), pool.indices.end(), _rng);
+        }
+        _table = std::make_unique<AliasTable>(weights);
+    }
+
+    std::vector<size_t> next(size_t count) override
+    {
+        std::vector<size_t> indices(count);
+        for (auto &index : indices) {
+            auto &pool = _pools[_table->sample(_rng)];
+            if (pool.cursor == pool.indices.size()) {
+                std::shuffle(pool.indices.begin(), pool.indices.end(), _rng);
+                pool.cursor = 0;
+            }
+            index = pool.indices[pool.cursor++];
+        }
+        return indices;
+    }
+
+    std::string describe() const override
+    {
+        std::ostringstream out;
+        out << "stratified (balance " << _balance << ", class sizes";
+        for (size_t i = 0; i < _pools.size(); i++) {
+            out << (i ? "/" : " ") << _pools[i].indices.size();
+        }
+        out << ")";
+        return out.str();
+    }
+
+    std::string state() const override
+    {
+        std::ostringstream out;
+        out << _rng << '\n' << _pools.size() << '\n';
+        for (const auto &pool : _pools) {
+            out << pool.cursor << ' ';
+            writeIndices(out, pool.indices);
+        }
+        return out.str();
+    }
+
+    void restore(const std::string &state) override
+    {
+        std::istringstream in(state);
+        size_t count = 0;
+        in >> _rng >> count;
+        if (!in || count != _pools.size()) {
+            throw std::runtime_error("Sampler state does not match the dataset");
+        }
+        for (auto &pool : _pools) {
+            in >> pool.cursor;
+            readIndices(in, pool.indices);
+        }
+        if (!in) {
+            throw std::runtime_error("Invalid stratified sampler state");
+        }
+    }
+
+    private:
+    struct Pool {
+        std::vector<size_t> indices;
+        size_t cursor{0};
+    };
+
+    std::vector<Pool> _pools;
+    std::unique_ptr<AliasTable> _table;
+    std::mt19937 _rng;
+    double _balance;
+};
+
+/**
+ *  @param labels Label index of every position of the dataset.
+ */
+inline std::unique_ptr<Sampler> makeSampler(
+    const SamplerOptions &options,
+    const std::vector<size_t> &labels,
+    uint64_t seed
+)
+{
+    if (options.type == "shuffle") {
+        return std::make_unique<ShuffleSampler>(labels.size(), seed);
+    }
+    if (options.type == "stratified") {
+        return std::make_unique<StratifiedSampler>(labels, options.balance, seed);
+    }
+    throw std::runtime_error("Unknown sampler: " + options.type + " (expected shuffle or stratified)");
+}
+
+} // namespace lava::train
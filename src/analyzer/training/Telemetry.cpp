@@ -0,0 +1,121 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** Telemetry
+*/
+
+#include "training/Telemetry.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include "Tensor/Memory.hpp"
+
+namespace lava::train {
+
+namespace {
+
+// JSON has no NaN nor infinity
+std::string number(double value)
+{
+    if (!std::isfinite(value)) {
+        return "null";
+    }
+    std::ostringstream out;
+    out << std::setprecision(6) << value;
+    return out.str();
+}
+
+} // namespace
+
+Telemetry::Telemetry(const std::string &path, double flopsPerSample, unsigned int threads, bool append) :
+    _flopsPerSample(flopsPerSample),
+    _threads(std::max(1u, threads)),
+    _path(path)
+{
+    if (!path.empty()) {
+        _file.open(path, append ? std::ios::app : std::ios::trunc);
+        if (!_file.is_open()) {
+            throw std::runtime_error("Could not open telemetry file: " + path);
+        }
+    }
+}
+
+void Telemetry::startEpoch()
+{
+    _start = std::chrono::steady_clock::now();
+    _allocations = memory::report().total.allocations;
+}
+
+void Telemetry::finishEpoch(const EpochTelemetry &epoch, std::ostream *progress)
+{
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+    const auto usage = memory::report().total;
+    const uint64_t allocations = usage.allocations - _allocations;
+
+    const double forward = epoch.workers.forwardNs.load() / 1e9;
+    const double backward = epoch.workers.backwardNs.load() / 1e9;
+    const double update = epoch.workers.updateNs.load() / 1e9;
+    const double busy = forward + backward + update;
+    auto share = [&](double threadSeconds) { return busy > 0 ? epoch.parallelSeconds * threadSeconds / busy : 0.0; };
+
+    // Wall-clock split of the epoch, other is what no phase covers (sampling, logging, ...)
+    std::array<std::pair<const char *, double>, 7> split = {{
+        {"data", epoch.dataSeconds},
+        {"forward", share(forward)},
+        {"backward", share(backward)},
+        {"optimizer", epoch.optimizerSeconds + share(update)},
+        {"checkpoint", epoch.checkpointSeconds},
+        {"validation", epoch.validationSeconds},
+        {"other", 0.0},
+    }};
+    double covered = 0;
+    for (const auto &[name, value] : split) {
+        covered += value;
+    }
+    split.back().second = std::max(0.0, seconds - covered);
+
+    const double samplesPerSecond = seconds > 0 ? epoch.samples / seconds : 0.0;
+    const double gflops = seconds > 0 ? epoch.samples * _flopsPerSample / seconds / 1e9 : 0.0;
+    const double utilization = seconds > 0 ? busy / (seconds * _threads) : 0.0;
+
+    if (_file.is_open()) {
+        _file << "{\"epoch\": " << epoch.epoch << ", \"epochs\": " << epoch.epochs << ", \"samples\": " << epoch.samples
+              << ", \"seconds\": " << number(seconds) << ", \"samples_per_sec\": " << number(samplesPerSecond)
+              << ", \"loss\": " << number(epoch.loss) << ", \"accuracy\": " << number(epoch.accuracy)
+              << ", \"learning_rate\": " << number(epoch.learningRate) << ", \"time\": {";
+        for (size_t i = 0; i < split.size(); i++) {
+            _file << (i ? ", " : "") << "\"" << split[i].first << "\": " << number(split[i].second);
+        }
+        _file << "}, \"gflops\": " << number(gflops) << ", \"threads\": " << _threads
+              << ", \"thread_utilization\": " << number(utilization) << ", \"allocations\": " << allocations
+              << ", \"peak_bytes\": " << usage.peak << "}" << std::endl;
+        if (!_file) {
+            throw std::runtime_error("Could not write the telemetry file: " + _path);
+        }
+    }
+
+    if (progress) {
+        auto flags = progress->flags();
+        auto precision = progress->precision();
+        *progress << "Throughput: " << std::fixed << std::setprecision(1) << samplesPerSecond << " samples/s - "
+                  << std::setprecision(2) << gflops << " GFLOP/s - Threads: " << std::setprecision(0)
+                  << utilization * 100 << "% busy (" << _threads << ") - Time:";
+        for (const auto &[name, value] : split) {
+            if (value > 0) {
+                *progress << " " << name << " " << std::setprecision(1) << (seconds > 0 ? 100 * value / seconds : 0)
+                          << "%";
+            }
+        }
+        *progress << " - Allocations: " << allocations << std::endl;
+        progress->flags(flags);
+        progress->precision(precision);
+    }
+}
+
+} // namespace lava::train
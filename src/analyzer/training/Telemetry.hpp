@@ -0,0 +1,90 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** Telemetry
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <string>
+
+namespace lava::train {
+
+/**
+ *  @brief Time spent by the worker threads during an epoch, summed over the threads.
+ */
+struct WorkerTimes {
+    std::atomic<int64_t> forwardNs{0}; /** Forward pass and loss */
+    std::atomic<int64_t> backwardNs{0};
+    std::atomic<int64_t> updateNs{0}; /** Updates applied by the workers themselves (hogwild) */
+
+    static int64_t since(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)
+            .count();
+    }
+};
+
+/**
+ *  @brief What an epoch did, filled in by the training loop. The times are wall-clock seconds of the
+ *         training thread, except for the worker times.
+ */
+struct EpochTelemetry {
+    size_t epoch{0};
+    size_t epochs{0};
+    size_t samples{0};
+    double loss{0.0}; /** Mean loss of the samples */
+    double accuracy{0.0};
+    double learningRate{0.0};
+    double dataSeconds{0.0}; /** Waiting for the batches */
+    double parallelSeconds{0.0}; /** Workers running forward and backward passes */
+    double optimizerSeconds{0.0}; /** Optimizer steps, gradient all-reduce included */
+    double checkpointSeconds{0.0};
+    double validationSeconds{0.0};
+    WorkerTimes workers;
+};
+
+/**
+ *  @brief Per-epoch training metrics: throughput, time split, achieved GFLOP/s, thread utilization and
+ *         allocations. Each epoch is appended to a JSONL file and summed up in a progress line.
+ *
+ *  The forward, backward and update times of the workers are summed over the threads: the wall time of
+ *  the parallel phase is split between them in proportion.
+ */
+class Telemetry {
+    public:
+    /**
+     *  @param path JSONL file, nothing is written when empty
+     *  @param flopsPerSample Floating point operations of the forward and backward passes of one sample
+     *  @param threads Worker threads of the training
+     *  @param append Adds to the lines of an interrupted training instead of truncating the file
+     */
+    Telemetry(const std::string &path, double flopsPerSample, unsigned int threads, bool append = false);
+
+    /**
+     *  @brief Starts the clock and the allocation count of the next epoch.
+     */
+    void startEpoch();
+
+    /**
+     *  @brief Writes the JSONL line of @param epoch, and its progress line to @param progress.
+     */
+    void finishEpoch(const EpochTelemetry &epoch, std::ostream *progress);
+
+    private:
+    double _flopsPerSample;
+    unsigned int _threads;
+    std::ofstream _file;
+    std::string _path;
+    std::chrono::steady_clock::time_point _start;
+    uint64_t _allocations{0};
+};
+
+} // namespace lava::train
@@ -0,0 +1,414 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** Transport
+*/
+
+#include "training/Transport.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace lava::train {
+
+namespace {
+
+constexpr auto CONNECT_TIMEOUT = std::chrono::seconds(60);
+
+std::runtime_error systemError(const std::string &what)
+{
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+/**
+ *  @brief Ring over TCP: one connection to the next rank, one accepted from the previous rank.
+ */
+class TcpTransport : public Transport {
+    public:
+    explicit TcpTransport(const DistributedOptions &options) : Transport(options.rank, options.worldSize)
+    {
+        auto peers = parsePeers(options.address.empty() ? "127.0.0.1:29500" : options.address);
+        int listener = listenOn(peers[_rank].second);
+
+        try {
+            _next = connectTo(peers[(_rank + 1) % _worldSize]);
+            _previous = acceptFrom(listener);
+        } catch (...) {
+            ::close(listener);
+            if (_next >= 0) {
+                ::close(_next);
+            }
+            throw;
+        }
+        ::close(listener);
+        for (int fd : {_next, _previous}) {
+            int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+        }
+    }
+
+    ~TcpTransport() override
+    {
+        for (int fd : {_next, _previous}) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+    }
+
+    void exchange(const void *send, size_t sendBytes, void *recv, size_t recvBytes) override
+    {
+        auto *out = static_cast<const char *>(send);
+        auto *in = static_cast<char *>(recv);
+
+        while (sendBytes > 0 || recvBytes > 0) {
+            pollfd fds[2] = {
+                {_next, sendBytes > 0 ? short(POLLOUT) : short(0), 0},
+                {_previous, recvBytes > 0 ? short(POLLIN) : short(0), 0}
+            };
+            if (::poll(fds, 2, -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw systemError("poll");
+            }
+            if (fds[0].revents & (POLLOUT | POLLERR | POLLHUP)) {
+                ssize_t n = ::send(_next, out, sendBytes, MSG_NOSIGNAL);
+                if (n < 0 && errno != EAGAIN && errno != EINTR) {
+                    throw systemError("Could not send to rank " + std::to_string((_rank + 1) % _worldSize));
+                }
+                out += std::max<ssize_t>(n, 0);
+                sendBytes -= std::max<ssize_t>(n, 0);
+            }
+            if (fds[1].revents & (POLLIN | POLLERR | POLLHUP)) {
+                ssize_t n = ::recv(_previous, in, recvBytes, 0);
+                if (n == 0) {
+                    throw std::runtime_error("Rank " + std::to_string(previousRank()) + " closed the connection");
+                }
+                if (n < 0 && errno != EAGAIN && errno != EINTR) {
+                    throw systemError("Could not receive from rank " + std::to_string(previousRank()));
+                }
+                in += std::max<ssize_t>(n, 0);
+                recvBytes -= std::max<ssize_t>(n, 0);
+            }
+        }
+    }
+
+    private:
+    using Peer = std::pair<std::string, std::string>;
+
+    size_t previousRank() const
+    {
+        return (_rank + _worldSize - 1) % _worldSize;
+    }
+
+    std::vector<Peer> parsePeers(const std::string &address) const
+    {
+        std::vector<Peer> peers;
+        size_t start = 0;
+        while (start <= address.size()) {
+            size_t end = std::min(address.find(',', start), address.size());
+            std::string entry = address.substr(start, end - start);
+            size_t colon = entry.rfind(':');
+            if (colon == std::string::npos) {
+                throw std::runtime_error("Invalid distributed address (expected HOST:PORT): " + entry);
+            }
+            peers.emplace_back(entry.substr(0, colon), entry.substr(colon + 1));
+            start = end + 1;
+        }
+        if (peers.size() == 1) {
+            // Every rank on the same host, on consecutive ports
+            int port = std::stoi(peers[0].second);
+            for (size_t r = 1; r < _worldSize; r++) {
+                peers.emplace_back(peers[0].first, std::to_string(port + r));
+            }
+        }
+        if (peers.size() != _worldSize) {
+            throw std::runtime_error("The distributed address must list 1 or world size HOST:PORT");
+        }
+        return peers;
+    }
+
+    int listenOn(const std::string &port) const
+    {
+        int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) {
+            throw systemError("socket");
+        }
+        int one = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons(static_cast<uint16_t>(std::stoi(port)));
+        if (::bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || ::listen(fd, 1) != 0) {
+            ::close(fd);
+            throw systemError("Could not listen on port " + port);
+        }
+        return fd;
+    }
+
+    int connectTo(const Peer &peer) const
+    {
+        addrinfo hints{};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo *result = nullptr;
+        if (::getaddrinfo(peer.first.c_str(), peer.second.c_str(), &hints, &result) != 0 || !result) {
+            throw std::runtime_error("Could not resolve " + peer.first + ":" + peer.second);
+        }
+
+        // The next rank may not be listening yet
+        auto deadline = std::chrono::steady_clock::now() + CONNECT_TIMEOUT;
+        while (true) {
+            int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+            if (fd >= 0 && ::connect(fd, result->ai_addr, result->ai_addrlen) == 0) {
+                ::freeaddrinfo(result);
+                uint32_t rank = static_cast<uint32_t>(_rank);
+                if (::send(fd, &rank, sizeof(rank), MSG_NOSIGNAL) != sizeof(rank)) {
+                    ::close(fd);
+                    throw systemError("Could not send the rank to " + peer.first + ":" + peer.second);
+                }
+                return fd;
+            }
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            if (std::chrono::steady_clock::now() > deadline) {
+                ::freeaddrinfo(result);
+                throw std::runtime_error("Could not connect to " + peer.first + ":" + peer.second);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    }
+
+    int acceptFrom(int listener) const
+    {
+        pollfd pfd{listener, POLLIN, 0};
+        int timeout = static_cast<int>(std::chrono::milliseconds(CONNECT_TIMEOUT).count());
+        if (::poll(&pfd, 1, timeout) <= 0) {
+            throw std::runtime_error("Rank " + std::to_string(previousRank()) + " did not connect");
+        }
+        int fd = ::accept(listener, nullptr, nullptr);
+        if (fd < 0) {
+            throw systemError("accept");
+        }
+        uint32_t rank = 0;
+        if (::recv(fd, &rank, sizeof(rank), MSG_WAITALL) != sizeof(rank) || rank != previousRank()) {
+            ::close(fd);
+            throw std::runtime_error("Unexpected connection, expected rank " + std::to_string(previousRank()));
+        }
+        return fd;
+    }
+
+    int _next{-1};
+    int _previous{-1};
+};
+
+/**
+ *  @brief Ring over POSIX shared memory: each rank owns a single-producer single-consumer byte ring
+ *         it writes to, read by the next rank.
+ *
+ *  NOTE: The owner removes its segment on exit. A reader waits for the owner to create it, and the
+ *        owner waits for the reader to attach, so a segment left by a crashed run fails with a timeout.
+ */
+class SharedMemoryTransport : public Transport {
+    public:
+    explicit SharedMemoryTransport(const DistributedOptions &options) : Transport(options.rank, options.worldSize)
+    {
+        std::string prefix = "/" + (options.address.empty() ? std::string("lava") : options.address);
+        _outName = prefix + "-" + std::to_string(_rank);
+
+        _out = create(_outName);
+        try {
+            _in = attach(prefix + "-" + std::to_string((_rank + _worldSize - 1) % _worldSize));
+            auto deadline = std::chrono::steady_clock::now() + CONNECT_TIMEOUT;
+            while (!_out->attached.load(std::memory_order_acquire)) {
+                if (std::chrono::steady_clock::now() > deadline) {
+                    throw std::runtime_error("Rank " + std::to_string((_rank + 1) % _worldSize) + " did not attach");
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        } catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    ~SharedMemoryTransport() override
+    {
+        release();
+    }
+
+    void exchange(const void *send, size_t sendBytes, void *recv, size_t recvBytes) override
+    {
+        auto *out = static_cast<const char *>(send);
+        auto *in = static_cast<char *>(recv);
+        size_t idle = 0;
+
+        while (sendBytes > 0 || recvBytes > 0) {
+            size_t progress = 0;
+            if (sendBytes > 0) {
+                uint64_t head = _out->head.load(std::memory_order_relaxed);
+                uint64_t tail = _out->tail.load(std::memory_order_acquire);
+                size_t n = std::min<size_t>(sendBytes, CAPACITY - (head - tail));
+                copyRing(_out->data, head, out, n, true);
+                _out->head.store(head + n, std::memory_order_release);
+                out += n;
+                sendBytes -= n;
+                progress += n;
+            }
+            if (recvBytes > 0) {
+                uint64_t head = _in->head.load(std::memory_order_acquire);
+                uint64_t tail = _in->tail.load(std::memory_order_relaxed);
+                size_t n = std::min<size_t>(recvBytes, head - tail);
+                copyRing(_in->data, tail, in, n, false);
+                _in->tail.store(tail + n, std::memory_order_release);
+                in += n;
+                recvBytes -= n;
+                progress += n;
+            }
+            if (progress == 0 && ++idle > 64) {
+                std::this_thread::yield();
+            } else if (progress > 0) {
+                idle = 0;
+            }
+        }
+    }
+
+    private:
+    static constexpr size_t CAPACITY = size_t(1) << 20;
+    static constexpr uint64_t MAGIC = 0x4c41564152494e47; // "LAVARING"
+
+    struct Segment {
+        std::atomic<uint64_t> magic;
+        std::atomic<bool> attached;
+        alignas(64) std::atomic<uint64_t> head; /** Bytes written, only moved by the owner */
+        alignas(64) std::atomic<uint64_t> tail; /** Bytes read, only moved by the reader */
+        alignas(64) char data[CAPACITY];
+    };
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared memory rings need lock-free atomics");
+    static constexpr size_t SEGMENT_SIZE = sizeof(Segment);
+
+    /**
+     *  @brief Copies @param bytes between @param buffer and the ring @param ring from its absolute
+     *         position @param position, wrapping around its end.
+     */
+    static void copyRing(char *ring, uint64_t position, const void *buffer, size_t bytes, bool toRing)
+    {
+        size_t offset = position % CAPACITY;
+        size_t first = std::min(bytes, CAPACITY - offset);
+        auto *data = static_cast<char *>(const_cast<void *>(buffer));
+        if (toRing) {
+            std::memcpy(ring + offset, data, first);
+            std::memcpy(ring, data + first, bytes - first);
+        } else {
+            std::memcpy(data, ring + offset, first);
+            std::memcpy(data + first, ring, bytes - first);
+        }
+    }
+
+    static Segment *map(int fd, const std::string &name)
+    {
+        void *memory = ::mmap(nullptr, SEGMENT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (memory == MAP_FAILED) {
+            throw systemError("Could not map shared memory " + name);
+        }
+        return static_cast<Segment *>(memory);
+    }
+
+    static Segment *create(const std::string &name)
+    {
+        ::shm_unlink(name.c_str());
+        int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) {
+            throw systemError("Could not create shared memory " + name);
+        }
+        if (::ftruncate(fd, SEGMENT_SIZE) != 0) {
+            ::close(fd);
+            ::shm_unlink(name.c_str());
+            throw systemError("Could not size shared memory " + name);
+        }
+        auto *segment = new (map(fd, name)) Segment{};
+        segment->magic.store(MAGIC, std::memory_order_release);
+        return segment;
+    }
+
+    static Segment *attach(const std::string &name)
+    {
+        auto deadline = std::chrono::steady_clock::now() + CONNECT_TIMEOUT;
+        while (true) {
+            int fd = ::shm_open(name.c_str(), O_RDWR, 0600);
+            struct stat st {};
+            if (fd >= 0 && ::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= SEGMENT_SIZE) {
+                auto *segment = map(fd, name);
+                if (segment->magic.load(std::memory_order_acquire) == MAGIC) {
+                    segment->attached.store(true, std::memory_order_release);
+                    return segment;
+                }
+                ::munmap(segment, SEGMENT_SIZE);
+            } else if (fd >= 0) {
+                ::close(fd);
+            }
+            if (std::chrono::steady_clock::now() > deadline) {
+                throw std::runtime_error("Shared memory " + name + " was not created");
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    void release()
+    {
+        if (_in) {
+            ::munmap(_in, SEGMENT_SIZE);
+            _in = nullptr;
+        }
+        if (_out) {
+            ::munmap(_out, SEGMENT_SIZE);
+            ::shm_unlink(_outName.c_str());
+            _out = nullptr;
+        }
+    }
+
+    std::string _outName;
+    Segment *_out{nullptr};
+    Segment *_in{nullptr};
+};
+
+} // namespace
+
+std::unique_ptr<Transport> makeTransport(const DistributedOptions &options)
+{
+    if (options.worldSize < 2 || options.rank >= options.worldSize) {
+        throw std::runtime_error("Distributed training needs a world size of at least 2 and a rank below it");
+    }
+    if (options.transport == "tcp") {
+        return std::make_unique<TcpTransport>(options);
+    }
+    if (options.transport == "shm") {
+        return std::make_unique<SharedMemoryTransport>(options);
+    }
+    throw std::runtime_error("Unknown transport: " + options.transport + " (expected tcp or shm)");
+}
+
+} // namespace lava::train
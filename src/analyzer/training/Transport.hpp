@@ -0,0 +1,69 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** Transport
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace lava::train {
+
+/**
+ *  @brief Position of a process in a data-parallel training and how it reaches the others.
+ */
+struct DistributedOptions {
+    size_t rank{0};
+    size_t worldSize{1};
+    std::string transport{"tcp"}; /** tcp or shm */
+    /**
+     *  tcp: HOST:PORT, rank r listening on PORT + r of HOST, or one HOST:PORT per rank separated by commas.
+     *  shm: name prefix of the shared memory segments.
+     */
+    std::string address;
+};
+
+/**
+ *  @brief Link of a process with its neighbours in a ring of worldSize() processes: it sends to
+ *         rank + 1 and receives from rank - 1 (modulo the world size).
+ */
+class Transport {
+    public:
+    virtual ~Transport() = default;
+
+    /**
+     *  @brief Sends @param sendBytes bytes of @param send to the next rank while receiving @param recvBytes
+     *         bytes from the previous one in @param recv. Returns once both are done.
+     *
+     *  NOTE: Both directions progress together, so a whole ring can exchange buffers of any size
+     *        without deadlocking.
+     */
+    virtual void exchange(const void *send, size_t sendBytes, void *recv, size_t recvBytes) = 0;
+
+    size_t rank() const
+    {
+        return _rank;
+    }
+
+    size_t worldSize() const
+    {
+        return _worldSize;
+    }
+
+    protected:
+    Transport(size_t rank, size_t worldSize) : _rank(rank), _worldSize(worldSize) {}
+
+    size_t _rank;
+    size_t _worldSize;
+};
+
+/**
+ *  @brief Connects this process to its ring neighbours, waiting for them to start.
+ */
+std::unique_ptr<Transport> makeTransport(const DistributedOptions &options);
+
+} // namespace lava::train
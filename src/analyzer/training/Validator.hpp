@@ -0,0 +1,163 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** Validator
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+#include "ChessboardParser.hpp"
+#include "Profiler/Profiler.hpp"
+#include "Tensor/Memory.hpp"
+#include "Tensor/Storage.hpp"
+#include "nn/CrossEntropyLoss.hpp"
+#include "nn/Linear.hpp"
+#include "nn/ReLU.hpp"
+#include "nn/Sequential.hpp"
+#include "nn/Softmax.hpp"
+
+namespace lava::train {
+
+/**
+ *  @tparam Type of the network weights.
+ *
+ *  @brief Evaluates snapshots of a network on the validation positions, on a background thread.
+ *
+ *  A snapshot is one copy of the parameter arena, on which an inference-only network is built as views:
+ *  the training goes on with the live weights while the snapshot is evaluated.
+ *
+ *  NOTE: One validation runs at a time, submitting a snapshot first waits for the previous result.
+ */
+template <typename T>
+class Validator {
+    public:
+    struct Result {
+        size_t epoch{0};
+        double loss{0.0};
+        double accuracy{0.0};
+        std::shared_ptr<nn::Sequential<T>> network; /** The evaluated snapshot */
+    };
+
+    /**
+     *  @param indices Validation positions in @param datas
+     *  @param labels Label index of every position of @param datas
+     */
+    Validator(
+        const std::vector<ChessboardParser::ChessboardData> &datas,
+        std::vector<size_t> indices,
+        const std::vector<size_t> &labels
+    )
+        : _datas(datas), _indices(std::move(indices)), _labels(labels)
+    {
+    }
+
+    Validator(const Validator &) = delete;
+    Validator &operator=(const Validator &) = delete;
+
+    ~Validator()
+    {
+        if (_pending.valid()) {
+            _pending.wait();
+        }
+    }
+
+    size_t size() const
+    {
+        return _indices.size();
+    }
+
+    /**
+     *  @brief Snapshots the weights of @param net after @param epoch and starts evaluating them.
+     *
+     *  @return The result of the previous snapshot, if any.
+     */
+    std::optional<Result> submit(nn::Sequential<T> &net, size_t epoch)
+    {
+        auto previous = finish();
+        auto snapshot = this->snapshot(net);
+        _pending = std::async(std::launch::async, [this, snapshot, epoch]() { return evaluate(snapshot, epoch); });
+        return previous;
+    }
+
+    /**
+     *  @brief Waits for the running validation.
+     *
+     *  @return Its result, or nothing when no snapshot is being evaluated.
+     */
+    std::optional<Result> finish()
+    {
+        if (!_pending.valid()) {
+            return std::nullopt;
+        }
+        return _pending.get();
+    }
+
+    private:
+    std::shared_ptr<nn::Sequential<T>> snapshot(nn::Sequential<T> &net) const
+    {
+        auto &parameters = net.parameters();
+        memory::Scope weights(memory::Category::WEIGHTS);
+        auto arena = std::make_shared<Storage<T>>(parameters.size());
+        std::memcpy(arena->data(), parameters.datas(), parameters.size() * sizeof(T));
+
+        auto view = [&](Tensor<T> &tensor) {
+            T *datas = arena->data() + parameters.offsetOf(tensor);
+            return TensorArray<T>(tensor.shape(), Storage<T>::view(datas, tensor.datas().size(), arena));
+        };
+        std::vector<std::shared_ptr<nn::Module<T>>> layers;
+        for (const auto &layer : net.layers()) {
+            if (auto linear = std::dynamic_pointer_cast<nn::Linear<T>>(layer)) {
+                layers.push_back(
+                    std::make_shared<nn::Linear<T>>(view(linear->_weights), view(linear->_biases), false)
+                );
+            } else if (std::dynamic_pointer_cast<nn::ReLU<T>>(layer)) {
+                layers.push_back(std::make_shared<nn::ReLU<T>>());
+            } else if (std::dynamic_pointer_cast<nn::Softmax<T>>(layer)) {
+                layers.push_back(std::make_shared<nn::Softmax<T>>());
+            } else {
+                throw std::runtime_error("Unsupported layer in validation snapshot");
+            }
+        }
+        return std::make_shared<nn::Sequential<T>>(layers);
+    }
+
+    Result evaluate(const std::shared_ptr<nn::Sequential<T>> &network, size_t epoch) const
+    {
+        profiler::Scope profile("Validator::evaluate");
+        nn::CrossEntropyLoss<T> criterion;
+        Result result{epoch, 0.0, 0.0, network};
+        Storage<T> buffer(_datas.empty() ? 0 : _datas[0].boardData.size());
+        std::vector<int> inputShape = {1, static_cast<int>(buffer.size())};
+        size_t correct = 0;
+
+        for (size_t idx : _indices) {
+            const auto &board = _datas[idx].boardData;
+            std::transform(board.begin(), board.end(), buffer.begin(), [](double v) { return static_cast<T>(v); });
+            Tensor<T> input(TensorArray<T>(inputShape, Storage<T>::view(buffer.data(), buffer.size())));
+
+            auto output = network->forward(input);
+            result.loss += criterion.forward(output, _labels[idx])[0];
+            correct += output.argmax() == _labels[idx];
+        }
+        if (!_indices.empty()) {
+            result.loss /= _indices.size();
+            result.accuracy = static_cast<double>(correct) / _indices.size();
+        }
+        return result;
+    }
+
+    const std::vector<ChessboardParser::ChessboardData> &_datas;
+    std::vector<size_t> _indices;
+    const std::vector<size_t> &_labels;
+    std::future<Result> _pending;
+};
+
+} // namespace lava::train
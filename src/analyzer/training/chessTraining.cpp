@@ -6,21 +6,35 @@
 */
 
 #include <algorithm>
+#include <array>
+#include <chrono>
 #include <cmath>
 #include <cstring>
 #include <future>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <numeric>
+#include <optional>
 #include <random>
 #include <thread>
 
+#include "Profiler/Profiler.hpp"
+#include "Tensor/Memory.hpp"
 #include "Tensor/TensorArray.hpp"
+#include "Tensor/autograd/GradientSink.hpp"
 #include "nn/CrossEntropyLoss.hpp"
-#include "nn/SGD.hpp"
+#include "nn/Optimizers.hpp"
 #include "nn/Sequential.hpp"
+#include "training/BatchPrefetcher.hpp"
+#include "training/Communicator.hpp"
+#include "training/Telemetry.hpp"
+#include "training/Validator.hpp"
 #include "training/chessTraining.hpp"
+#include "utils/CheckpointWriter.hpp"
+#include "utils/NetworkLoader.hpp"
 #include "utils/NetworkSaver.hpp"
+#include "utils/TrainingState.hpp"
 
 namespace lava::train {
 
@@ -36,157 +50,757 @@ size_t getLabelIndex(const std::string &labelStr)
     return 5; // Nothing
 }
 
+TrainingConfig makeTrainingConfig(const NetworkConfig &networkConfig)
+{
+    TrainingConfig config;
+    const auto &hyperparameters = networkConfig.hyperparameters();
+    config.learningRate = hyperparameters.learningRate;
+    config.batchSize = hyperparameters.batchSize;
+    config.accumulationSteps = hyperparameters.accumulationSteps;
+    config.hogwild = hyperparameters.trainingMode == "hogwild";
+    config.recomputeSegment = hyperparameters.recomputeSegment;
+    config.epochs = hyperparameters.epochs;
+    config.samplesPerEpoch = hyperparameters.samplesPerEpoch;
+
+    const auto &lrScheduler = networkConfig.lrScheduler();
+    config.scheduler.type = lrScheduler.type;
+    config.scheduler.decayRate = lrScheduler.decayRate;
+    config.scheduler.decaySteps = lrScheduler.decaySteps;
+    config.scheduler.minLR = lrScheduler.minLR;
+    config.scheduler.warmupSteps = lrScheduler.warmupSteps;
+    config.scheduler.pctStart = lrScheduler.pctStart;
+    config.scheduler.patience = lrScheduler.patience;
+
+    const auto &optimizer = networkConfig.optimizer();
+    config.optimizer.type = nn::optimizerTypeFromString(optimizer.type);
+    config.optimizer.momentum = optimizer.momentum;
+    config.optimizer.beta1 = optimizer.beta1;
+    config.optimizer.beta2 = optimizer.beta2;
+    config.optimizer.epsilon = optimizer.epsilon;
+    config.optimizer.weightDecay = optimizer.weightDecay;
+    config.optimizer.maxGrad = optimizer.gradClip;
+
+    config.sampler.type = networkConfig.sampler().type;
+    config.sampler.balance = networkConfig.sampler().balance;
+
+    config.validation.split = networkConfig.validation().split;
+    config.validation.patience = networkConfig.validation().patience;
+    config.validation.minDelta = networkConfig.validation().minDelta;
+
+    config.checkpointInterval = networkConfig.checkpoint().interval;
+    config.checkpointKeep = networkConfig.checkpoint().keep;
+
+    config.mixedPrecision.type = networkConfig.mixedPrecision().type;
+    config.mixedPrecision.lossScale = networkConfig.mixedPrecision().lossScale;
+    config.mixedPrecision.growthInterval = networkConfig.mixedPrecision().growthInterval;
+    return config;
+}
+
 void trainSummary(const std::vector<ChessboardParser::ChessboardData> &datas, const TrainingConfig &config)
 {
     std::cout << "\nStarting training with " << datas.size() << " total samples" << std::endl;
     std::cout << "Training Configuration:" << std::endl;
     std::cout << "----------------------" << std::endl;
+    std::cout << "Optimizer: " << nn::optimizerTypeName(config.optimizer.type) << std::endl;
+    std::cout << "Training mode: " << (config.hogwild ? "hogwild" : "sync") << std::endl;
+    if (config.distributed.worldSize > 1) {
+        std::cout << "Distributed: " << config.distributed.worldSize << " ranks over " << config.distributed.transport
+                  << std::endl;
+    }
     std::cout << "Initial learning rate: " << config.learningRate << std::endl;
     std::cout << "Batch size: " << config.batchSize << std::endl;
+    if (config.accumulationSteps > 1) {
+        std::cout << "Accumulation steps: " << config.accumulationSteps
+                  << " (effective batch size: " << config.batchSize * config.accumulationSteps << ")" << std::endl;
+    }
+    if (config.recomputeSegment > 0) {
+        std::cout << "Activation checkpointing: segments of " << config.recomputeSegment << " layers" << std::endl;
+    }
     std::cout << "Samples per epoch: " << config.samplesPerEpoch << std::endl;
     std::cout << "Number of epochs: " << config.epochs << std::endl;
     std::cout << "Save file: " << (config.saveFile.empty() ? "none" : config.saveFile) << std::endl;
     std::cout << "Should save: " << (config.shouldSave ? "yes" : "no") << std::endl;
-    if (config.schedulerType != "none") {
-        std::cout << "Learning rate scheduler: " << config.schedulerType << std::endl;
-        std::cout << "Decay rate: " << config.decayRate << std::endl;
-        std::cout << "Decay steps: " << config.decaySteps << std::endl;
-        std::cout << "Minimum learning rate: " << config.minLearningRate << std::endl;
+    if (config.shouldSave) {
+        std::cout << "Checkpoint every " << config.checkpointInterval << " epochs, keeping " << config.checkpointKeep
+                  << std::endl;
+    }
+    const auto &scheduler = config.scheduler;
+    if (scheduler.type != "none" || scheduler.warmupSteps > 0) {
+        std::cout << "Learning rate scheduler: " << scheduler.type << std::endl;
+        if (scheduler.type == "exponential" || scheduler.type == "step") {
+            std::cout << "Decay rate: " << scheduler.decayRate << " every " << scheduler.decaySteps << " epochs"
+                      << std::endl;
+        } else if (scheduler.type == "plateau") {
+            std::cout << "Decay rate: " << scheduler.decayRate << " after " << scheduler.patience
+                      << " epochs without improvement" << std::endl;
+        } else if (scheduler.type == "one_cycle") {
+            std::cout << "Rising phase: " << scheduler.pctStart * 100 << "% of the steps" << std::endl;
+        }
+        if (scheduler.warmupSteps > 0) {
+            std::cout << "Warmup steps: " << scheduler.warmupSteps << std::endl;
+        }
+        std::cout << "Minimum learning rate: " << scheduler.minLR << std::endl;
+    }
+    if (config.validation.split > 0) {
+        std::cout << "Validation split: " << config.validation.split << std::endl;
+        std::cout << "Early stopping patience: "
+                  << (config.validation.patience ? std::to_string(config.validation.patience) : "off") << std::endl;
     }
     std::cout << "----------------------" << std::endl;
 }
 
-void networkSummary(lava::nn::Sequential<double> *sequential) // In nn.Module
+template <typename T>
+void networkSummary(lava::nn::Sequential<T> *sequential) // In nn.Module
 {
     std::cout << "\nNetwork Architecture:" << std::endl;
     std::cout << "----------------------" << std::endl;
     for (size_t i = 0; i < sequential->layers().size(); ++i) {
         const auto &layer = sequential->layers()[i];
-        if (auto linear = std::dynamic_pointer_cast<nn::Linear<double>>(layer)) {
+        if (auto linear = std::dynamic_pointer_cast<nn::Linear<T>>(layer)) {
             std::cout << "Layer " << i << ": Linear(in=" << linear->_weights.tensor().shape()[0]
                       << ", out=" << linear->_weights.shape()[1] << ")" << std::endl;
-        } else if (std::dynamic_pointer_cast<nn::ReLU<double>>(layer)) {
+        } else if (std::dynamic_pointer_cast<nn::ReLU<T>>(layer)) {
             std::cout << "Layer " << i << ": ReLU" << std::endl;
-        } else if (std::dynamic_pointer_cast<nn::Softmax<double>>(layer)) {
+        } else if (std::dynamic_pointer_cast<nn::Softmax<T>>(layer)) {
             std::cout << "Layer " << i << ": Softmax" << std::endl;
         }
     }
     std::cout << "----------------------" << std::endl;
 }
 
-void chessTrain(
-    nn::Module<double> &net,
+struct EpochResult {
+    double loss{0.0}; /** Sum of the sample losses */
+    size_t correct{0};
+};
+
+/**
+ *  @brief Synchronous epoch: the samples of each micro-batch are split between the threads, which all
+ *         join before the (accumulated) optimizer step.
+ *
+ *  @param scheduler Learning rate of each optimizer step
+ *  @param mixed When set, the loss is scaled and the steps whose gradients overflowed are skipped
+ *  @param communicator When set, the gradients are summed over the ranks before each step, and the
+ *                      result covers the samples of every rank.
+ *  @param chunkGrads Private gradient arenas of the sample chunks, grown to the number of chunks
+ *  @param telemetry Receives the time spent in the passes and in the optimizer steps
+ *
+ *  NOTE: Each chunk accumulates in its own arena, summed in chunk order into the gradients of the network,
+ *        so the gradients and the loss do not depend on the scheduling of the threads.
+ */
+template <typename T>
+EpochResult synchronousEpoch(
+    nn::Module<T> &net,
+    BatchPrefetcher<T> &prefetcher,
+    nn::Optimizer<T> &optimizer,
+    nn::LRScheduler &scheduler,
+    nn::MixedPrecision<T> *mixed,
+    const TrainingConfig &config,
+    unsigned int numThreads,
+    Communicator *communicator,
+    std::vector<Storage<T>> &chunkGrads,
+    EpochTelemetry &telemetry
+)
+{
+    nn::CrossEntropyLoss<T> criterion;
+    auto &parameters = net.parameters();
+    const size_t size = parameters.size();
+    EpochResult total;
+
+    // Process micro-batches, the gradients are accumulated over accumulationSteps of them before each step
+    size_t accumulated = 0;
+    auto *batch = prefetcher.next();
+    while (batch) {
+        size_t batchSize = batch->size;
+        if (accumulated == 0) {
+            optimizer.zeroGrad();
+        }
+
+        // Parallel processing of batch samples
+        auto parallelStart = std::chrono::steady_clock::now();
+        std::vector<std::future<EpochResult>> futures;
+        size_t chunkSize = std::max(size_t(1), batchSize / numThreads);
+        {
+            memory::Scope scope(memory::Category::GRADS);
+            while (chunkGrads.size() < (batchSize + chunkSize - 1) / chunkSize) {
+                chunkGrads.emplace_back(size, T(0));
+            }
+        }
+
+        for (size_t start = 0; start < batchSize; start += chunkSize) {
+            size_t end = std::min(start + chunkSize, batchSize);
+            futures.push_back(std::async(std::launch::async, [&, start, end]() {
+                GradientSink<T> sink(parameters.grads(), chunkGrads[start / chunkSize].data(), size);
+                EpochResult local;
+                int64_t forwardNs = 0;
+                int64_t backwardNs = 0;
+
+                for (size_t j = start; j < end; j++) {
+                    profiler::Scope profile("train::sample");
+                    auto sampleStart = std::chrono::steady_clock::now();
+                    // The input is a view on the prefetched batch, which outlives the graph
+                    std::vector<int> inputShape = {1, static_cast<int>(batch->inputSize)};
+                    Tensor<T> input(TensorArray<T>(inputShape, Storage<T>::view(batch->input(j), batch->inputSize)));
+
+                    auto output = net.forward(input);
+                    size_t labelIndex = batch->labels[j];
+                    size_t predictedClass = output.argmax();
+
+                    auto loss = criterion.forward(output, labelIndex);
+                    auto backwardStart = std::chrono::steady_clock::now();
+                    forwardNs += std::chrono::nanoseconds(backwardStart - sampleStart).count();
+                    if (mixed) {
+                        mixed->backward(loss, output);
+                    } else {
+                        loss.backward();
+                    }
+                    backwardNs += WorkerTimes::since(backwardStart);
+
+                    local.loss += loss[0];
+                    if (predictedClass == labelIndex) {
+                        local.correct++;
+                    }
+                }
+
+                telemetry.workers.forwardNs += forwardNs;
+                telemetry.workers.backwardNs += backwardNs;
+                return local;
+            }));
+        }
+
+        // Wait for all threads to complete, then sum their results in chunk order
+        T *grads = parameters.grads();
+        for (size_t chunk = 0; chunk < futures.size(); chunk++) {
+            auto local = futures[chunk].get();
+            total.loss += local.loss;
+            total.correct += local.correct;
+            T *chunkGrad = chunkGrads[chunk].data();
+            for (size_t i = 0; i < size; i++) {
+                grads[i] += chunkGrad[i];
+            }
+            std::fill(chunkGrad, chunkGrad + size, T(0));
+        }
+        telemetry.parallelSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - parallelStart)
+                                         .count();
+
+        batch = prefetcher.next();
+        accumulated++;
+        if (accumulated == config.accumulationSteps || !batch) {
+            profiler::Scope profile("train::step");
+            auto stepStart = std::chrono::steady_clock::now();
+            if (communicator) {
+                communicator->allReduce(parameters.grads(), size);
+            }
+            // Average the per micro-batch gradients, clipping then applies to the averaged gradient
+            double lossScale = mixed ? mixed->lossScale() : 1.0;
+            optimizer.setGradScale(static_cast<T>(1.0 / (accumulated * lossScale)));
+            optimizer.setLearningRate(static_cast<T>(scheduler.learningRate()));
+            if (mixed) {
+                mixed->step(optimizer, parameters.grads(), size);
+            } else {
+                optimizer.step();
+            }
+            scheduler.step();
+            accumulated = 0;
+            telemetry.optimizerSeconds +=
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - stepStart).count();
+        }
+    }
+    telemetry.dataSeconds = prefetcher.stats().waitSeconds;
+    std::array<double, 2> totals = {total.loss, static_cast<double>(total.correct)};
+    if (communicator) {
+        communicator->allReduce(totals.data(), totals.size());
+    }
+    return {totals[0], static_cast<size_t>(totals[1])};
+}
+
+/**
+ *  @brief Hogwild! epoch: each thread trains on its own shard of @param indices and applies its updates to the
+ *         shared weights after every few samples, without locks and without waiting for the other threads.
+ *
+ *  @param workerGrads One private gradient arena per thread
+ *  @param times Receives the time the threads spent in the passes and in their updates
+ *
+ *  NOTE: Each thread updates after batchSize / threads samples, so the whole pool applies about one batch of
+ *        gradients between two updates of a given thread, like the synchronous trainer.
+ */
+template <typename T>
+EpochResult hogwildEpoch(
+    nn::Module<T> &net,
     const std::vector<ChessboardParser::ChessboardData> &datas,
-    const TrainingConfig &config
+    const std::vector<size_t> &labels,
+    const std::vector<size_t> &indices,
+    std::vector<Storage<T>> &workerGrads,
+    const TrainingConfig &config,
+    T learningRate,
+    WorkerTimes &times
 )
 {
-    nn::CrossEntropyLoss<double> criterion;
-    auto *sequential = dynamic_cast<nn::Sequential<double> *>(&net);
-    if (!sequential) {
-        throw std::runtime_error("Network must be Sequential");
+    auto &parameters = net.parameters();
+    const size_t size = parameters.size();
+    const size_t numWorkers = workerGrads.size();
+    const size_t interval = std::max(size_t(1), config.batchSize / numWorkers);
+    const auto weightDecay = static_cast<T>(config.optimizer.weightDecay);
+    const auto maxGrad = static_cast<T>(config.optimizer.maxGrad);
+    std::vector<std::future<EpochResult>> futures;
+
+    for (size_t worker = 0; worker < numWorkers; worker++) {
+        futures.push_back(std::async(std::launch::async, [&, worker]() {
+            T *grads = workerGrads[worker].data();
+            GradientSink<T> sink(parameters.grads(), grads, size);
+            nn::CrossEntropyLoss<T> criterion;
+            EpochResult result;
+            Storage<T> buffer(datas.empty() ? 0 : datas[0].boardData.size());
+            std::vector<int> inputShape = {1, static_cast<int>(buffer.size())};
+            size_t pending = 0;
+            int64_t forwardNs = 0;
+            int64_t backwardNs = 0;
+            int64_t updateNs = 0;
+
+            for (size_t k = worker; k < indices.size(); k += numWorkers) {
+                profiler::Scope profile("train::sample");
+                auto sampleStart = std::chrono::steady_clock::now();
+                const auto &board = datas[indices[k]].boardData;
+                std::transform(board.begin(), board.end(), buffer.begin(), [](double v) { return static_cast<T>(v); });
+                Tensor<T> input(TensorArray<T>(inputShape, Storage<T>::view(buffer.data(), buffer.size())));
+
+                auto output = net.forward(input);
+                size_t labelIndex = labels[indices[k]];
+                auto loss = criterion.forward(output, labelIndex);
+                auto backwardStart = std::chrono::steady_clock::now();
+                forwardNs += std::chrono::nanoseconds(backwardStart - sampleStart).count();
+                loss.backward();
+                backwardNs += WorkerTimes::since(backwardStart);
+
+                result.loss += loss[0];
+                result.correct += output.argmax() == labelIndex;
+                if (++pending == interval || k + numWorkers >= indices.size()) {
+                    auto updateStart = std::chrono::steady_clock::now();
+                    nn::SGD<T>::sparseStep(parameters.datas(), grads, size, learningRate, weightDecay, maxGrad);
+                    updateNs += WorkerTimes::since(updateStart);
+                    pending = 0;
+                }
+            }
+            times.forwardNs += forwardNs;
+            times.backwardNs += backwardNs;
+            times.updateNs += updateNs;
+            return result;
+        }));
     }
-    nn::SGD<double> optimizer(sequential->layers(), config.learningRate);
 
-    // Create indices for the entire dataset
-    std::vector<size_t> allIndices(datas.size());
-    std::iota(allIndices.begin(), allIndices.end(), 0);
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    EpochResult total;
+    for (auto &future : futures) {
+        auto result = future.get();
+        total.loss += result.loss;
+        total.correct += result.correct;
+    }
+    return total;
+}
 
-    trainSummary(datas, config);
-    networkSummary(sequential);
+/**
+ *  @brief Follows the validation results: keeps the best loss, saves the best snapshot next to the save file
+ *         and counts the validations without improvement for early stopping.
+ */
+template <typename T>
+class ValidationTracker {
+    public:
+    ValidationTracker(const TrainingConfig &config, CheckpointWriter &writer) : _config(config), _writer(writer)
+    {
+        if (!config.saveFile.empty()) {
+            std::string stem = config.saveFile;
+            if (stem.size() > 3 && stem.ends_with(".nn")) {
+                stem.resize(stem.size() - 3);
+            }
+            _bestFile = stem + "_best.nn";
+        }
+    }
 
-    const unsigned int numThreads = std::thread::hardware_concurrency();
-    const size_t samplesPerEpoch = std::min(config.samplesPerEpoch, datas.size());
+    const std::string &bestFile() const
+    {
+        return _bestFile;
+    }
 
-    for (size_t epoch = 0; epoch < config.epochs; epoch++) {
-        // Update learning rate if scheduler is enabled
-        if (config.schedulerType == "exponential") {
-            double newLR =
-                config.learningRate * std::pow(config.decayRate, static_cast<double>(epoch) / config.decaySteps);
-            newLR = std::max(newLR, config.minLearningRate);
-            optimizer.setLearningRate(newLR);
+    void report(const typename Validator<T>::Result &result)
+    {
+        std::cout << "Validation (epoch " << result.epoch + 1 << ") - Loss: " << std::fixed << std::setprecision(4)
+                  << result.loss << " - Accuracy: " << std::setprecision(2) << result.accuracy * 100 << "%";
+        if (result.loss < _bestLoss - _config.validation.minDelta) {
+            _bestLoss = result.loss;
+            _bestAccuracy = result.accuracy;
+            _bestEpoch = result.epoch;
+            _staleValidations = 0;
+            if (!_bestFile.empty()) {
+                _writer.submit(
+                    _bestFile, NetworkSaver::serializeNetwork(result.network, NetworkLoader::getLastLoadedConfig())
+                );
+                std::cout << " - best, saved to " << _bestFile;
+            }
+        } else {
+            _staleValidations++;
         }
+        std::cout << std::endl;
+    }
 
-        double epochLoss = 0.0;
-        std::atomic<size_t> correct{0};
+    void saveState(TrainingState &state) const
+    {
+        state.bestLoss = _bestLoss;
+        state.bestAccuracy = _bestAccuracy;
+        state.bestEpoch = _bestEpoch;
+        state.staleValidations = _staleValidations;
+    }
 
-        // Standard shuffle without execution policy
-        std::shuffle(allIndices.begin(), allIndices.end(), gen);
+    void restore(const TrainingState &state)
+    {
+        _bestLoss = state.bestLoss;
+        _bestAccuracy = state.bestAccuracy;
+        _bestEpoch = state.bestEpoch;
+        _staleValidations = state.staleValidations;
+    }
 
-        // Create epoch indices (subset of shuffled indices)
-        std::vector<size_t> epochIndices(allIndices.begin(), allIndices.begin() + samplesPerEpoch);
+    bool shouldStop() const
+    {
+        return _config.validation.patience > 0 && _staleValidations >= _config.validation.patience;
+    }
 
-        // Process batches
-        for (size_t i = 0; i < samplesPerEpoch; i += config.batchSize) {
-            size_t batchSize = std::min(config.batchSize, samplesPerEpoch - i);
-            std::atomic<double> batchLoss{0.0};
-            optimizer.zeroGrad();
+    void summary() const
+    {
+        if (_bestLoss == std::numeric_limits<double>::infinity()) {
+            return;
+        }
+        std::cout << "Best validation: epoch " << _bestEpoch + 1 << " - Loss: " << std::fixed << std::setprecision(4)
+                  << _bestLoss << " - Accuracy: " << std::setprecision(2) << _bestAccuracy * 100 << "%" << std::endl;
+    }
 
-            // Parallel processing of batch samples
-            std::vector<std::future<void>> futures;
-            size_t chunkSize = std::max(size_t(1), batchSize / numThreads);
+    private:
+    const TrainingConfig &_config;
+    CheckpointWriter &_writer;
+    std::string _bestFile;
+    double _bestLoss{std::numeric_limits<double>::infinity()};
+    double _bestAccuracy{0.0};
+    size_t _bestEpoch{0};
+    size_t _staleValidations{0};
+};
 
-            for (size_t start = 0; start < batchSize; start += chunkSize) {
-                size_t end = std::min(start + chunkSize, batchSize);
-                futures.push_back(std::async(std::launch::async, [&, start, end]() {
-                    double localLoss = 0.0;
-                    size_t localCorrect = 0;
+/**
+ *  @brief Multiply-adds of the Linear layers for one training sample, counted as two flops: the forward
+ *         pass, the weight gradients and the input gradients (except for the first layer, whose input
+ *         needs none).
+ */
+template <typename T>
+double trainingFlops(nn::Sequential<T> &net)
+{
+    double flops = 0;
+    bool first = true;
+    for (const auto &layer : net.layers()) {
+        if (auto linear = std::dynamic_pointer_cast<nn::Linear<T>>(layer)) {
+            const auto &shape = linear->_weights.tensor().shape();
+            double products = 2.0 * shape[0] * shape[1];
+            flops += (first ? 2 : 3) * products;
+            first = false;
+        }
+    }
+    return flops;
+}
 
-                    for (size_t j = start; j < end; j++) {
-                        const auto &board = datas[epochIndices[i + j]];
+template <typename T>
+void chessTrain(
+    nn::Module<T> &net,
+    const std::vector<ChessboardParser::ChessboardData> &datas,
+    const TrainingConfig &config
+)
+{
+    auto *sequential = dynamic_cast<nn::Sequential<T> *>(&net);
+    if (!sequential) {
+        throw std::runtime_error("Network must be Sequential");
+    }
+    if (config.hogwild && (config.optimizer.type != nn::OptimizerType::SGD || config.accumulationSteps != 1)) {
+        throw std::runtime_error("Hogwild training only supports the sgd optimizer without gradient accumulation");
+    }
+    if (config.hogwild && config.distributed.worldSize > 1) {
+        throw std::runtime_error("Hogwild training cannot be distributed");
+    }
+    sequential->setCheckpointSegment(config.recomputeSegment);
+    auto optimizer = nn::makeOptimizer(net.parameters(), static_cast<T>(config.learningRate), config.optimizer);
+    std::unique_ptr<nn::MixedPrecision<T>> mixed;
+    if (config.mixedPrecision.type != "none") {
+        if (config.hogwild) {
+            throw std::runtime_error("Mixed precision only supports the sync training mode");
+        }
+        mixed = std::make_unique<nn::MixedPrecision<T>>(*sequential, config.mixedPrecision);
+    }
 
-                        std::vector<int> inputShape = {1, static_cast<int>(board.boardData.size())};
-                        std::vector<int> strides = {static_cast<int>(board.boardData.size()), 1};
-                        std::vector<double> normalizedData = board.boardData;
+    // Every rank loads the same network and dataset, then trains on its share of each batch
+    std::unique_ptr<Communicator> communicator;
+    if (config.distributed.worldSize > 1) {
+        communicator = std::make_unique<Communicator>(makeTransport(config.distributed));
+    }
+    // Rank 0 validates, saves and decides for every rank, and reports the progress unless it is quiet
+    const bool lead = config.distributed.rank == 0;
+    const bool verbose = lead && !config.quiet;
 
-                        lava::TensorArray<double> tensorArray(inputShape, strides);
-                        tensorArray.datas() = normalizedData;
-                        Tensor<double> input(tensorArray);
+    // The positions are drawn the same way on every rank
+    std::vector<size_t> labels;
+    labels.reserve(datas.size());
+    for (const auto &board : datas) {
+        labels.push_back(getLabelIndex(board.expectedOutput));
+    }
+    // A resumed training continues the split and the sampling of the interrupted one
+    std::optional<TrainingState> resumed;
+    if (config.resume) {
+        resumed = NetworkLoader::loadTrainingState(config.loadFile);
+        if (!resumed) {
+            throw std::runtime_error("Cannot resume: " + config.loadFile + " holds no training state");
+        }
+    }
+    const size_t firstEpoch = resumed ? resumed->epoch : 0;
+    uint64_t seed = resumed ? resumed->seed : config.seed.value_or(std::random_device{}());
+    if (communicator) {
+        seed = lead ? seed : 0;
+        communicator->allReduce(&seed, 1);
+    }
 
-                        auto output = net.forward(input);
-                        size_t labelIndex = getLabelIndex(board.expectedOutput);
-                        size_t predictedClass = output.argmax();
+    // Hold out the validation positions, the same ones on every rank
+    std::vector<size_t> trainIndices(datas.size());
+    std::iota(trainIndices.begin(), trainIndices.end(), 0);
+    std::vector<size_t> validationIndices;
+    if (config.validation.split > 0) {
+        std::mt19937_64 splitRng(seed);
+        std::shuffle(trainIndices.begin(), trainIndices.end(), splitRng);
+        size_t count = static_cast<size_t>(config.validation.split * datas.size());
+        if (count == 0 || count == datas.size()) {
+            throw std::runtime_error("The validation split must leave positions for training and validation");
+        }
+        validationIndices.assign(trainIndices.end() - count, trainIndices.end());
+        trainIndices.resize(datas.size() - count);
+    }
+    std::vector<size_t> trainLabels;
+    trainLabels.reserve(trainIndices.size());
+    for (size_t idx : trainIndices) {
+        trainLabels.push_back(labels[idx]);
+    }
+    auto sampler = makeSampler(config.sampler, trainLabels, seed);
+    if (resumed) {
+        sampler->restore(resumed->samplerState);
+    }
 
-                        auto loss = criterion.forward(output, labelIndex);
-                        loss.backward();
+    // Checkpoints are serialized by the training thread and written by a background one
+    CheckpointWriter writer;
+    std::unique_ptr<Validator<T>> validator;
+    ValidationTracker<T> tracker(config, writer);
+    if (resumed) {
+        tracker.restore(*resumed);
+    }
+    if (!validationIndices.empty() && lead) {
+        validator = std::make_unique<Validator<T>>(datas, std::move(validationIndices), labels);
+    }
 
-                        localLoss += loss[0];
-                        if (predictedClass == labelIndex) {
-                            localCorrect++;
-                        }
-                    }
+    if (verbose) {
+        trainSummary(datas, config);
+        networkSummary(sequential);
+        std::cout << "Sampler: " << sampler->describe() << std::endl;
+        if (mixed) {
+            std::cout << "Mixed precision: " << mixed->describe() << std::endl;
+        }
+        if (validator) {
+            std::cout << "Validation: " << validator->size() << " positions held out, best checkpoint saved to "
+                      << (tracker.bestFile().empty() ? "none" : tracker.bestFile()) << std::endl;
+        }
+    }
+    if (!config.loadFile.empty() && NetworkLoader::loadOptimizerState(config.loadFile, *optimizer) && verbose) {
+        std::cout << "Optimizer state restored from " << config.loadFile << " (step " << optimizer->steps() << ")"
+                  << std::endl;
+    }
+    if (resumed && verbose) {
+        std::cout << "Resuming after epoch " << firstEpoch << "/" << config.epochs << std::endl;
+    }
+    // The checkpoint holds the snapshot whose validation was running, it is evaluated again
+    if (resumed && validator && firstEpoch > 0) {
+        validator->submit(*sequential, firstEpoch - 1);
+    }
 
-                    batchLoss += localLoss;
-                    correct += localCorrect;
-                }));
-            }
+    const unsigned int numThreads = config.threads > 0
+        ? static_cast<unsigned int>(config.threads)
+        : std::max(1u, std::thread::hardware_concurrency());
+    // A shuffled epoch holds each position at most once, a stratified stream has no such bound
+    const size_t samplesPerEpoch = config.sampler.type == "shuffle"
+        ? std::min(config.samplesPerEpoch, trainIndices.size())
+        : config.samplesPerEpoch;
+    BatchPrefetcher<T> prefetcher(datas, config.batchSize, config.distributed.rank, config.distributed.worldSize);
 
-            // Wait for all threads to complete
-            for (auto &future : futures) {
-                future.wait();
-            }
+    const size_t batchesPerEpoch = (samplesPerEpoch + config.batchSize - 1) / config.batchSize;
+    const size_t stepsPerEpoch = config.hogwild
+        ? batchesPerEpoch
+        : (batchesPerEpoch + config.accumulationSteps - 1) / config.accumulationSteps;
+    auto scheduler =
+        nn::makeScheduler(config.learningRate, config.scheduler, stepsPerEpoch, stepsPerEpoch * config.epochs);
+    if (resumed && !resumed->schedulerState.empty()) {
+        scheduler->restore(resumed->schedulerState);
+    }
+
+    Telemetry telemetry(lead ? config.telemetryFile : "", trainingFlops(*sequential), numThreads, config.resume);
 
-            optimizer.step();
-            epochLoss += static_cast<double>(batchLoss) / batchSize;
+    // Hogwild! workers and synchronous chunks accumulate in private gradient arenas
+    std::vector<Storage<T>> workerGrads;
+    if (config.hogwild) {
+        memory::Scope scope(memory::Category::GRADS);
+        for (unsigned int i = 0; i < numThreads; i++) {
+            workerGrads.emplace_back(net.parameters().size(), T(0));
+        }
+    }
+
+    for (size_t epoch = firstEpoch; epoch < config.epochs; epoch++) {
+        profiler::Scope profile("train::epoch");
+        memory::resetPeaks();
+        telemetry.startEpoch();
+        EpochTelemetry record;
+        std::vector<size_t> epochIndices = sampler->next(samplesPerEpoch);
+        for (auto &idx : epochIndices) {
+            idx = trainIndices[idx];
         }
 
-        double accuracy = static_cast<double>(correct) / samplesPerEpoch;
-        std::cout << "Epoch " << epoch + 1 << "/" << config.epochs << " (" << samplesPerEpoch
-                  << " samples) - Loss: " << std::fixed << std::setprecision(4)
-                  << epochLoss * config.batchSize / samplesPerEpoch << " - Accuracy: " << std::fixed
-                  << std::setprecision(2) << accuracy * 100 << "% - LR: " << std::scientific << std::setprecision(3)
-                  << optimizer.getLearningRate() << std::endl;
+        EpochResult result;
+        if (config.hogwild) {
+            // The workers step on their own, the whole epoch uses the rate of its first step
+            optimizer->setLearningRate(static_cast<T>(scheduler->learningRate()));
+            auto parallelStart = std::chrono::steady_clock::now();
+            result = hogwildEpoch(
+                net, datas, labels, epochIndices, workerGrads, config, optimizer->getLearningRate(), record.workers
+            );
+            record.parallelSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - parallelStart)
+                                         .count();
+            scheduler->step(stepsPerEpoch);
+        } else {
+            prefetcher.startEpoch(std::move(epochIndices));
+            result = synchronousEpoch(
+                net, prefetcher, *optimizer, *scheduler, mixed.get(), config, numThreads, communicator.get(),
+                workerGrads, record
+            );
+        }
+        bool stop = false;
+        // Loss followed by plateau schedules, the validation loss when there is one
+        double monitored = std::numeric_limits<double>::quiet_NaN();
+        const double accuracy = static_cast<double>(result.correct) / samplesPerEpoch;
+        if (verbose) {
+            std::cout << "Epoch " << epoch + 1 << "/" << config.epochs << " (" << samplesPerEpoch
+                      << " samples) - Loss: " << std::fixed << std::setprecision(4) << result.loss / samplesPerEpoch
+                      << " - Accuracy: " << std::fixed << std::setprecision(2) << accuracy * 100
+                      << "% - LR: " << std::scientific << std::setprecision(3) << optimizer->getLearningRate();
+            if (!config.hogwild) {
+                auto dataStats = prefetcher.stats();
+                std::cout << " - Data wait: " << std::fixed << std::setprecision(1) << dataStats.waitSeconds * 1000
+                          << "ms (" << dataStats.stalls << "/" << dataStats.batches << " batches)";
+            }
+            std::cout << std::endl;
+            memory::printReport(std::cout, "Memory");
+        }
+        if (lead) {
+            // The snapshot of this epoch is evaluated during the next one
+            if (validator) {
+                profiler::Scope validationProfile("train::validation");
+                auto validationStart = std::chrono::steady_clock::now();
+                if (auto previous = validator->submit(*sequential, epoch)) {
+                    tracker.report(*previous);
+                    monitored = previous->loss;
+                }
+                stop = tracker.shouldStop();
+                record.validationSeconds =
+                    std::chrono::duration<double>(std::chrono::steady_clock::now() - validationStart).count();
+            } else {
+                monitored = result.loss / samplesPerEpoch;
+            }
+            if (config.onEpoch) {
+                EpochControl control{epoch + 1, result.loss / samplesPerEpoch, accuracy, *scheduler};
+                stop = !config.onEpoch(control) || stop;
+                if (control.resetOptimizer) {
+                    optimizer->reset();
+                }
+            }
+        }
+        if (communicator) {
+            // Rank 0 decides for every rank, the others contribute zeros
+            bool observed = !std::isnan(monitored);
+            std::array<double, 3> decision = {stop ? 1.0 : 0.0, observed ? 1.0 : 0.0, observed ? monitored : 0.0};
+            communicator->allReduce(decision.data(), decision.size());
+            stop = decision[0] > 0;
+            monitored = decision[1] > 0 ? decision[2] : std::numeric_limits<double>::quiet_NaN();
+        }
+        if (!std::isnan(monitored)) {
+            scheduler->observe(monitored);
+        }
 
-        if (config.shouldSave && !config.saveFile.empty() && (epoch + 1) % 10 == 0) {
-            NetworkSaver::saveNetwork(
-                std::shared_ptr<nn::Sequential<double>>(sequential, [](nn::Sequential<double> *) {}), config.saveFile
+        bool checkpoint = config.checkpointInterval > 0 && (epoch + 1) % config.checkpointInterval == 0;
+        if (lead && config.shouldSave && !config.saveFile.empty() && checkpoint) {
+            profiler::Scope checkpointProfile("train::checkpoint");
+            auto checkpointStart = std::chrono::steady_clock::now();
+            TrainingState state;
+            state.epoch = epoch + 1;
+            state.seed = seed;
+            state.samplerState = sampler->state();
+            state.schedulerState = scheduler->state();
+            tracker.saveState(state);
+            writer.submit(
+                config.saveFile,
+                NetworkSaver::serializeNetwork(
+                    std::shared_ptr<nn::Sequential<T>>(sequential, [](nn::Sequential<T> *) {}),
+                    NetworkLoader::getLastLoadedConfig(),
+                    optimizer.get(),
+                    &state
+                ),
+                config.checkpointKeep
             );
-            std::cout << "Checkpoint saved to " << config.saveFile << std::endl;
+            if (verbose) {
+                std::cout << "Checkpoint queued for " << config.saveFile << std::endl;
+            }
+            record.checkpointSeconds =
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - checkpointStart).count();
+        }
+        if (lead) {
+            record.epoch = epoch + 1;
+            record.epochs = config.epochs;
+            record.samples = samplesPerEpoch;
+            record.loss = result.loss / samplesPerEpoch;
+            record.accuracy = accuracy;
+            record.learningRate = optimizer->getLearningRate();
+            telemetry.finishEpoch(record, verbose ? &std::cout : nullptr);
+        }
+        if (stop) {
+            if (verbose && tracker.shouldStop()) {
+                std::cout << "Early stopping: no validation improvement for " << config.validation.patience
+                          << " epochs" << std::endl;
+            }
+            break;
         }
     }
 
-    std::cout << "\nTraining completed!" << std::endl;
+    if (lead) {
+        if (validator) {
+            if (auto last = validator->finish()) {
+                tracker.report(*last);
+            }
+            tracker.summary();
+        }
+        writer.flush();
+    }
+    if (verbose) {
+        if (mixed) {
+            std::cout << "Mixed precision: " << mixed->skippedSteps() << " steps skipped on overflow, final loss scale "
+                      << std::defaultfloat << std::setprecision(6) << mixed->lossScale() << std::endl;
+        }
+        std::cout << "\nTraining completed!" << std::endl;
+    }
 }
 
+template void networkSummary<double>(nn::Sequential<double> *sequential);
+template void networkSummary<float>(nn::Sequential<float> *sequential);
+
+template void chessTrain<double>(
+    nn::Module<double> &net,
+    const std::vector<ChessboardParser::ChessboardData> &datas,
+    const TrainingConfig &config
+);
+template void chessTrain<float>(
+    nn::Module<float> &net,
+    const std::vector<ChessboardParser::ChessboardData> &datas,
+    const TrainingConfig &config
+);
+
 } // namespace lava::train
@@ -7,36 +7,94 @@
 
 #pragma once
 
+#include <cstdint>
+#include <functional>
+#include <optional>
 #include <string>
 #include <vector>
 #include "ChessboardParser.hpp"
+#include "nn/LRScheduler.hpp"
+#include "nn/MixedPrecision.hpp"
 #include "nn/Module.hpp"
+#include "nn/Optimizer.hpp"
 #include "nn/Sequential.hpp"
+#include "training/Sampler.hpp"
+#include "training/Transport.hpp"
+#include "utils/NetworkConfig.hpp"
 
 namespace lava::train {
 
+struct ValidationOptions {
+    double split{0.0}; /** Fraction of the positions held out for validation, 0 disables it */
+    size_t patience{0}; /** Validations without improvement before stopping, 0 disables early stopping */
+    double minDelta{0.0}; /** Decrease of the validation loss counted as an improvement */
+};
+
+/**
+ *  @brief End of an epoch, as seen by the onEpoch callback of a training.
+ */
+struct EpochControl {
+    size_t epoch{0}; /** Epochs done, from 1 */
+    double loss{0.0}; /** Mean training loss of the epoch */
+    double accuracy{0.0};
+    nn::LRScheduler &scheduler; /** Its base rate and decay rate can be changed for the next epochs */
+    bool resetOptimizer{false}; /** Set by a callback which replaced the weights, drops the optimizer state */
+};
+
 struct TrainingConfig {
     size_t epochs{100};
     double learningRate{0.1};
-    size_t batchSize{32};
+    size_t batchSize{32}; /** Micro-batch size: samples processed concurrently */
+    size_t accumulationSteps{1}; /** Micro-batches accumulated before each optimizer step */
+    bool hogwild{false}; /** Lock-free asynchronous updates from every thread instead of one step per batch */
+    size_t recomputeSegment{0}; /** Layers per activation checkpointing segment, 0 keeps every activation */
     size_t samplesPerEpoch{10000};
+    std::string loadFile; /** Checkpoint the optimizer state is restored from, if it holds one */
+    bool resume{false}; /** Continues the training loop saved in loadFile instead of starting at epoch 0 */
     std::string saveFile;
     bool shouldSave{false};
-    std::string schedulerType{"none"};
-    double decayRate{1.0};
-    size_t decaySteps{100};
-    double minLearningRate{0.0001};
+    size_t checkpointInterval{10}; /** Epochs between two checkpoints, 0 disables them */
+    size_t checkpointKeep{1}; /** Rotating checkpoints kept: saveFile, saveFile.1, ... */
+    std::string telemetryFile; /** Per-epoch metrics written as JSON lines when set, appended to on resume */
+    nn::SchedulerOptions scheduler;
+    nn::MixedPrecisionOptions mixedPrecision;
+    nn::OptimizerOptions optimizer;
+    SamplerOptions sampler;
+    ValidationOptions validation;
+    DistributedOptions distributed;
+    std::optional<uint64_t> seed; /** Shuffling seed, random when not set */
+    size_t threads{0}; /** Worker threads, 0 uses every hardware thread */
+    bool quiet{false}; /** No progress output, for trainings running side by side */
+    std::function<bool(EpochControl &)> onEpoch; /** Called on rank 0 after each epoch, false stops the training */
 };
 
+/**
+ *  @brief Training options of the `.conf` sections of @param networkConfig, the run options (files,
+ *         seed, distribution, ...) keep their defaults.
+ */
+TrainingConfig makeTrainingConfig(const NetworkConfig &networkConfig);
+
+/**
+ *  @brief Index of the output class named by the expected output of a training position.
+ */
+size_t getLabelIndex(const std::string &labelStr);
+
 void trainSummary(
     const std::vector<ChessboardParser::ChessboardData> &datas,
     const TrainingConfig &config
 );
 
-void networkSummary(lava::nn::Sequential<double> *sequential);
+template <typename T>
+void networkSummary(lava::nn::Sequential<T> *sequential);
 
+/**
+ *  @brief Trains @param net on the chess positions @param datas.
+ *
+ *  NOTE: Instantiated for float and double networks.
+ */
+template <typename T>
 void chessTrain(
-    lava::nn::Module<double> &net,
+    lava::nn::Module<T> &net,
     const std::vector<ChessboardParser::ChessboardData> &datas,
     const TrainingConfig &config = TrainingConfig{}
 );
@@ -0,0 +1,188 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** Benchmark
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace lava::bench {
+
+/**
+ *  @brief Timings of one benchmark case, in nanoseconds per iteration.
+ */
+struct Result {
+    std::string name;
+    std::vector<std::pair<std::string, double>> params; /** Sizes of the case (eg. matmul m, k and n) */
+    size_t iterations{0};
+    double meanNs{0};
+    double medianNs{0};
+    double minNs{0};
+    double maxNs{0};
+    double work{0}; /** Units of work done by one iteration, throughput is work / median time */
+    std::string unit; /** Unit of the throughput (eg. GFLOP/s) */
+    double unitScale{1}; /** Work per unit of the throughput (eg. 1e9 flops per GFLOP) */
+
+    double throughput() const
+    {
+        return medianNs > 0 ? work / unitScale / (medianNs / 1e9) : 0.0;
+    }
+};
+
+/**
+ *  @brief Times benchmark cases and writes their results as JSON.
+ *
+ *  Each case runs once untimed (warmup), then is timed call by call until it ran for @param minSeconds and
+ *  at least MIN_ITERATIONS times. The median is the reference value, it is the least sensitive to the noise.
+ */
+class Runner {
+    public:
+    static constexpr size_t MIN_ITERATIONS = 3;
+    static constexpr size_t MAX_ITERATIONS = 1000000;
+
+    Runner(double minSeconds, std::string filter) : _minSeconds(minSeconds), _filter(std::move(filter)) {}
+
+    /**
+     *  @return False when the case is filtered out by the name filter.
+     */
+    bool selected(const std::string &name) const
+    {
+        return _filter.empty() || name.find(_filter) != std::string::npos;
+    }
+
+    /**
+     *  @param work Units of work done by one call of @param fn
+     *  @param unit Throughput unit, @param unitScale units of work per throughput unit
+     */
+    template <typename Fn>
+    void run(
+        const std::string &name,
+        std::vector<std::pair<std::string, double>> params,
+        double work,
+        std::string unit,
+        double unitScale,
+        Fn &&fn
+    )
+    {
+        if (!selected(name)) {
+            return;
+        }
+
+        fn();
+        std::vector<double> samples;
+        double elapsed = 0;
+        while ((elapsed < _minSeconds * 1e9 || samples.size() < MIN_ITERATIONS) && samples.size() < MAX_ITERATIONS) {
+            auto start = std::chrono::steady_clock::now();
+            fn();
+            auto duration = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+            samples.push_back(duration.count());
+            elapsed += duration.count();
+        }
+
+        Result result;
+        result.name = name;
+        result.params = std::move(params);
+        result.iterations = samples.size();
+        result.meanNs = elapsed / samples.size();
+        std::sort(samples.begin(), samples.end());
+        size_t middle = samples.size() / 2;
+        result.medianNs = samples.size() % 2 ? samples[middle] : (samples[middle - 1] + samples[middle]) / 2;
+        result.minNs = samples.front();
+        result.maxNs = samples.back();
+        result.work = work;
+        result.unit = std::move(unit);
+        result.unitScale = unitScale;
+
+        // On the error output, the standard output may be the JSON report
+        auto flags = std::cerr.flags();
+        auto precision = std::cerr.precision();
+        std::cerr << std::left << std::setw(28) << result.name << std::right << std::setw(12) << std::fixed
+                  << std::setprecision(3) << result.medianNs / 1e3 << " us " << std::setw(12) << std::setprecision(2)
+                  << result.throughput() << " " << result.unit << describe(result.params) << std::endl;
+        std::cerr.flags(flags);
+        std::cerr.precision(precision);
+        _results.push_back(std::move(result));
+    }
+
+    const std::vector<Result> &results() const
+    {
+        return _results;
+    }
+
+    /**
+     *  @brief Writes the results, after the @param context key/value pairs describing the run.
+     */
+    void writeJson(std::ostream &out, const std::vector<std::pair<std::string, std::string>> &context) const
+    {
+        out << "{\n";
+        for (const auto &[key, value] : context) {
+            out << "  \"" << key << "\": \"" << escape(value) << "\",\n";
+        }
+        out << "  \"min_seconds\": " << number(_minSeconds) << ",\n";
+        out << "  \"results\": [";
+        for (size_t i = 0; i < _results.size(); i++) {
+            const auto &result = _results[i];
+            out << (i ? ",\n" : "\n") << "    {\"name\": \"" << escape(result.name) << "\", \"params\": {";
+            for (size_t j = 0; j < result.params.size(); j++) {
+                out << (j ? ", " : "") << "\"" << escape(result.params[j].first)
+                    << "\": " << number(result.params[j].second);
+            }
+            out << "}, \"iterations\": " << result.iterations << ", \"mean_ns\": " << number(result.meanNs)
+                << ", \"median_ns\": " << number(result.medianNs) << ", \"min_ns\": " << number(result.minNs)
+                << ", \"max_ns\": " << number(result.maxNs) << ", \"throughput\": " << number(result.throughput())
+                << ", \"unit\": \"" << escape(result.unit) << "\"}";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+    private:
+    static std::string escape(const std::string &value)
+    {
+        std::string escaped;
+        for (char c : value) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+            }
+            escaped += c;
+        }
+        return escaped;
+    }
+
+    // JSON has no NaN nor infinity
+    static std::string number(double value)
+    {
+        if (!std::isfinite(value)) {
+            return "null";
+        }
+        std::ostringstream out;
+        out << std::setprecision(6) << value;
+        return out.str();
+    }
+
+    static std::string describe(const std::vector<std::pair<std::string, double>> &params)
+    {
+        std::string text;
+        for (const auto &[key, value] : params) {
+            text += (text.empty() ? " (" : ", ") + key + "=" + number(value);
+        }
+        return text.empty() ? text : text + ")";
+    }
+
+    double _minSeconds;
+    std::string _filter;
+    std::vector<Result> _results;
+};
+
+} // namespace lava::bench
@@ -0,0 +1,361 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** main
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "ArgParser.hpp"
+#include "ChessboardParser.hpp"
+#include "bench/Benchmark.hpp"
+#include "generator/NetworkGenerator.hpp"
+#include "nn/Sequential.hpp"
+#include "training/chessTraining.hpp"
+#include "utils/NetworkConfig.hpp"
+#include "utils/NetworkLoader.hpp"
+
+namespace {
+
+// Used when no dataset is given, one or two positions of each output class
+const std::vector<std::string> POSITIONS = {
+    "1rNr4/5K2/8/8/8/k7/8/8 w - - 0 1 Checkmate White",
+    "8/8/2k5/8/8/8/2K5/8 w - - 0 1 Checkmate White",
+    "8/8/8/8/2K2p2/6k1/8/8 w - - 0 1 Checkmate Black",
+    "8/8/8/8/1K1k4/8/2Bp4/8 w - - 0 1 Checkmate Black",
+    "3p4/4K3/8/8/8/8/1Q5b/6k1 w - - 0 1 Check White",
+    "8/6r1/6n1/4K2P/3Q4/3B4/k7/1R2b2N w - - 0 1 Check White",
+    "2B5/7n/8/1b4q1/5k2/7q/2KR2r1/8 w - - 0 1 Check Black",
+    "r7/2k1q1N1/5K2/8/n1p5/8/1n6/8 w - - 0 1 Check Black",
+    "8/8/8/P7/8/2K5/6k1/8 w - - 0 1 Stalemate",
+    "8/8/8/7k/3K4/8/8/8 w - - 0 1 Stalemate",
+    "8/K6b/8/8/k7/8/8/7b w - - 0 1 Nothing",
+    "3p4/8/8/4r3/8/8/6k1/1K6 w - - 0 1 Nothing",
+    "rnbqkbnr/pp1ppppp/8/2p5/4P3/8/PPPP1PPP/RNBQKBNR w KQkq c6 0 2 Nothing",
+};
+
+constexpr size_t BUILTIN_POSITIONS = 512;
+// Samples of the timed training epoch: a few batches, the epoch of a wide network takes seconds
+constexpr size_t TRAINING_SAMPLES = 128;
+// Every run benchmarks the same weights
+constexpr uint64_t NETWORK_SEED = 42;
+
+/**
+ *  @brief Drops everything written on the standard output while alive: the training loop reports its
+ *         progress there, and it may hold the JSON report.
+ */
+class QuietOutput {
+    public:
+    QuietOutput() : _buffer(std::cout.rdbuf(nullptr)) {}
+
+    QuietOutput(const QuietOutput &) = delete;
+    QuietOutput &operator=(const QuietOutput &) = delete;
+
+    ~QuietOutput()
+    {
+        std::cout.rdbuf(_buffer);
+        std::cout.clear();
+    }
+
+    private:
+    std::streambuf *_buffer;
+};
+
+template <typename T>
+lava::TensorArray<T> randomTensor(const std::vector<int> &shape, std::mt19937 &gen)
+{
+    size_t size = 1;
+    for (int dim : shape) {
+        size *= dim;
+    }
+    lava::Storage<T> datas(size);
+    std::uniform_real_distribution<T> dist(-1, 1);
+    std::generate(datas.begin(), datas.end(), [&]() { return dist(gen); });
+    return lava::TensorArray<T>(shape, std::move(datas));
+}
+
+/**
+ *  @brief Input tensor of one position, as built by --predict.
+ */
+template <typename T>
+lava::Tensor<T> boardInput(const ChessboardParser::ChessboardData &board)
+{
+    lava::Storage<T> datas(board.boardData.size());
+    std::copy(board.boardData.begin(), board.boardData.end(), datas.begin());
+    return lava::Tensor<T>(lava::TensorArray<T>({1, static_cast<int>(datas.size())}, std::move(datas)), false);
+}
+
+/**
+ *  @brief Matmul of every Linear layer as done by training, one position at a time: forward, weight gradient
+ *         (outer product) and input gradient.
+ */
+template <typename T>
+void benchKernels(lava::bench::Runner &runner, const lava::NetworkConfig &config)
+{
+    std::mt19937 gen(42);
+    const auto &arch = config.architecture();
+    std::vector<int> sizes = {static_cast<int>(arch.inputSize)};
+    for (size_t size : arch.hiddenSizes) {
+        sizes.push_back(static_cast<int>(size));
+    }
+    sizes.push_back(static_cast<int>(arch.outputSize));
+
+    auto matmul = [&](const std::string &name, int m, int k, int n) {
+        if (!runner.selected(name)) {
+            return;
+        }
+        auto a = randomTensor<T>({m, k}, gen);
+        auto b = randomTensor<T>({k, n}, gen);
+        runner.run(name, {{"m", m}, {"k", k}, {"n", n}}, 2.0 * m * k * n, "GFLOP/s", 1e9, [&]() {
+            auto c = a.matmul(b);
+        });
+    };
+    for (size_t i = 0; i + 1 < sizes.size(); i++) {
+        std::string layer = "_" + std::to_string(sizes[i]) + "x" + std::to_string(sizes[i + 1]);
+        matmul("matmul_forward" + layer, 1, sizes[i], sizes[i + 1]);
+        matmul("matmul_weight_grad" + layer, sizes[i], 1, sizes[i + 1]);
+
+        // Gradient of the layer input: the weights are read through transposed strides, as in MMBackward
+        if (runner.selected("matmul_input_grad" + layer)) {
+            const int in = sizes[i];
+            const int out = sizes[i + 1];
+            auto grad = randomTensor<T>({1, out}, gen);
+            auto weights = randomTensor<T>({in, out}, gen);
+            weights.transposed();
+            runner.run(
+                "matmul_input_grad" + layer, {{"m", 1}, {"k", out}, {"n", in}}, 2.0 * in * out, "GFLOP/s", 1e9,
+                [&]() { auto c = grad.matmul(weights); }
+            );
+        }
+    }
+
+    // Element-wise ops on the largest weight matrix, as in the optimizer updates
+    if (!runner.selected("elementwise") && !runner.selected("transpose")) {
+        return;
+    }
+    const int rows = sizes[0];
+    const int cols = sizes[1];
+    const double count = static_cast<double>(rows) * cols;
+    std::vector<std::pair<std::string, double>> shape = {{"rows", rows}, {"cols", cols}};
+    auto a = randomTensor<T>({rows, cols}, gen);
+    auto b = randomTensor<T>({rows, cols}, gen);
+    // The operators build expressions, evaluated when they become a TensorArray
+    runner.run("elementwise_add", shape, count, "Melem/s", 1e6, [&]() { lava::TensorArray<T> c = a + b; });
+    runner.run("elementwise_mul", shape, count, "Melem/s", 1e6, [&]() { lava::TensorArray<T> c = a * b; });
+    runner.run("elementwise_scale", shape, count, "Melem/s", 1e6, [&]() { lava::TensorArray<T> c = a * T(0.5); });
+    runner.run("elementwise_fused", shape, count, "Melem/s", 1e6, [&]() {
+        lava::TensorArray<T> c = (a - b) * (a - b) * T(0.5) + b;
+    });
+    runner.run("elementwise_add_inplace", shape, count, "Melem/s", 1e6, [&]() { a += b; });
+    runner.run("transpose", shape, count, "Melem/s", 1e6, [&]() { auto c = a.transpose(); });
+}
+
+void benchPositions(lava::bench::Runner &runner, const std::vector<ChessboardParser::ChessboardData> &boards)
+{
+    const double count = static_cast<double>(boards.size());
+    std::vector<std::pair<std::string, double>> params = {{"positions", count}};
+    runner.run("fen_validate", params, count, "positions/s", 1, [&]() {
+        for (const auto &board : boards) {
+            if (FenValidator::validateFEN(board.fen)) {
+                throw std::runtime_error("Invalid benchmark position: " + board.fen);
+            }
+        }
+    });
+    runner.run("fen_convert", params, count, "positions/s", 1, [&]() {
+        for (const auto &board : boards) {
+            auto input = FenConverter::convertBoard(board.fen);
+        }
+    });
+}
+
+/**
+ *  @brief Loads the network at @param path like --predict (mapped weights) and --train (owned weights), and
+ *         times predictions with the mapped one.
+ */
+template <typename T>
+void benchModel(
+    lava::bench::Runner &runner,
+    const std::string &path,
+    const lava::NetworkConfig &config,
+    const std::vector<ChessboardParser::ChessboardData> &boards
+)
+{
+    const double bytes = static_cast<double>(std::filesystem::file_size(path));
+    runner.run("model_load_mapped", {{"bytes", bytes}}, bytes, "MB/s", 1e6, [&]() {
+        auto model = lava::NetworkLoader::loadNetwork<T>(path, true);
+    });
+    runner.run("model_load", {{"bytes", bytes}}, bytes, "MB/s", 1e6, [&]() {
+        auto model = lava::NetworkLoader::loadNetwork<T>(path, false);
+    });
+
+    auto model = lava::NetworkLoader::loadNetwork<T>(path, true);
+    size_t next = 0;
+    size_t predicted = 0;
+    runner.run("predict", {{"positions", 1}}, 1, "positions/s", 1, [&]() {
+        auto input = boardInput<T>(boards[next++ % boards.size()]);
+        predicted += model->forward(input).argmax();
+    });
+
+    // The layers take one position at a time: a batch is predicted position by position, like a --predict file
+    const size_t batch = config.hyperparameters().batchSize;
+    runner.run("predict_batch", {{"positions", static_cast<double>(batch)}}, batch, "positions/s", 1, [&]() {
+        for (size_t i = 0; i < batch; i++) {
+            auto input = boardInput<T>(boards[next++ % boards.size()]);
+            predicted += model->forward(input).argmax();
+        }
+    });
+    // Uses the predictions, so that they are not optimized out
+    if (predicted == static_cast<size_t>(-1)) {
+        std::cerr << predicted << std::endl;
+    }
+}
+
+/**
+ *  @brief Times one training epoch of the network at @param path, with the optimizer and the batch size of
+ *         its configuration and without checkpoints nor validation.
+ */
+template <typename T>
+void benchTraining(
+    lava::bench::Runner &runner,
+    const std::string &path,
+    const lava::NetworkConfig &config,
+    const std::vector<ChessboardParser::ChessboardData> &boards
+)
+{
+    if (!runner.selected("train_epoch")) {
+        return;
+    }
+    auto model = lava::NetworkLoader::loadNetwork<T>(path, false);
+
+    lava::train::TrainingConfig training;
+    const auto &hyperparameters = config.hyperparameters();
+    training.epochs = 1;
+    training.samplesPerEpoch = std::min(boards.size(), TRAINING_SAMPLES);
+    training.learningRate = hyperparameters.learningRate;
+    training.batchSize = hyperparameters.batchSize;
+    training.accumulationSteps = hyperparameters.accumulationSteps;
+    training.hogwild = hyperparameters.trainingMode == "hogwild";
+    training.recomputeSegment = hyperparameters.recomputeSegment;
+    training.optimizer.type = lava::nn::optimizerTypeFromString(config.optimizer().type);
+    training.optimizer.momentum = config.optimizer().momentum;
+    training.optimizer.beta1 = config.optimizer().beta1;
+    training.optimizer.beta2 = config.optimizer().beta2;
+    training.optimizer.epsilon = config.optimizer().epsilon;
+    training.optimizer.weightDecay = config.optimizer().weightDecay;
+    training.optimizer.maxGrad = config.optimizer().gradClip;
+    training.mixedPrecision.type = config.mixedPrecision().type;
+    training.mixedPrecision.lossScale = config.mixedPrecision().lossScale;
+    training.mixedPrecision.growthInterval = config.mixedPrecision().growthInterval;
+    training.checkpointInterval = 0;
+    training.seed = 42;
+
+    const double samples = static_cast<double>(training.samplesPerEpoch);
+    std::vector<std::pair<std::string, double>> params = {
+        {"samples", samples}, {"batch", static_cast<double>(training.batchSize)}
+    };
+    runner.run("train_epoch", params, samples, "samples/s", 1, [&]() {
+        QuietOutput quiet;
+        lava::train::chessTrain(*model, boards, training);
+    });
+}
+
+/**
+ *  @brief Positions of @param path, or the built-in ones repeated up to BUILTIN_POSITIONS.
+ */
+std::vector<ChessboardParser::ChessboardData> loadPositions(const std::string &path, const std::string &scratch)
+{
+    if (!path.empty()) {
+        auto boards = ChessboardParser::parseChessboardFile(path);
+        if (boards.empty()) {
+            throw std::runtime_error("No positions in " + path);
+        }
+        return boards;
+    }
+    {
+        std::ofstream file(scratch);
+        for (size_t i = 0; i < BUILTIN_POSITIONS; i++) {
+            file << POSITIONS[i % POSITIONS.size()] << "\n";
+        }
+    }
+    auto boards = ChessboardParser::parseChessboardFile(scratch);
+    std::filesystem::remove(scratch);
+    return boards;
+}
+
+std::string timestamp()
+{
+    std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    char buffer[32] = {};
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    return buffer;
+}
+
+template <typename T>
+void benchAll(lava::bench::Runner &runner, const ArgParser::BenchArgs &args, const lava::NetworkConfig &config)
+{
+    auto scratch = std::filesystem::temp_directory_path() / ("lava_bench_" + std::to_string(::getpid()));
+    auto boards = loadPositions(args.datasetFile, scratch.string() + ".txt");
+    const std::string network = scratch.string() + ".nn";
+    lava::NetworkGenerator::generateNetwork(config, network, NETWORK_SEED);
+
+    try {
+        benchKernels<T>(runner, config);
+        benchPositions(runner, boards);
+        benchModel<T>(runner, network, config, boards);
+        benchTraining<T>(runner, network, config, boards);
+    } catch (...) {
+        std::filesystem::remove(network);
+        throw;
+    }
+    std::filesystem::remove(network);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    try {
+        auto args = ArgParser::parseBenchArgs(argc, argv);
+        auto config = lava::NetworkConfig::fromFile(args.configFile);
+        const bool useFloat = config.architecture().dtype == lava::DataType::FLOAT32;
+
+        lava::bench::Runner runner(args.minSeconds, args.filter);
+        if (useFloat) {
+            benchAll<float>(runner, args, config);
+        } else {
+            benchAll<double>(runner, args, config);
+        }
+
+        std::vector<std::pair<std::string, std::string>> context = {
+            {"timestamp", timestamp()},
+            {"config", args.configFile},
+            {"dataset", args.datasetFile.empty() ? "built-in" : args.datasetFile},
+            {"dtype", useFloat ? "float32" : "float64"},
+            {"threads", std::to_string(std::max(1u, std::thread::hardware_concurrency()))},
+        };
+        if (args.outputFile.empty()) {
+            runner.writeJson(std::cout, context);
+            return 0;
+        }
+        std::ofstream file(args.outputFile);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open benchmark output file: " + args.outputFile);
+        }
+        runner.writeJson(file, context);
+        std::cerr << "Benchmark results written to " << args.outputFile << std::endl;
+        return 0;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 84;
+    }
+}
@@ -5,27 +5,99 @@
 ** main
 */
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <filesystem>
 #include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
 #include "ArgParser.hpp"
+#include "Tensor/Philox.hpp"
 #include "generator/NetworkGenerator.hpp"
 #include "utils/NetworkConfig.hpp"
 
+namespace {
+
+struct Job {
+    const lava::NetworkConfig *config;
+    std::string configFile;
+    std::string outputFile;
+    uint64_t seed;
+};
+
+/**
+ *  @brief Generates the networks of @param jobs side by side, each worker filling its network on its
+ *         share of the hardware threads. The first error is rethrown once every worker stopped.
+ */
+void generateAll(const std::vector<Job> &jobs)
+{
+    const size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    const size_t workers = std::min(jobs.size(), hardware);
+    const size_t threads = std::max<size_t>(1, hardware / workers);
+
+    std::atomic<size_t> next{0};
+    std::mutex mutex;
+    std::exception_ptr error;
+    auto work = [&]() {
+        for (size_t i = next++; i < jobs.size(); i = next++) {
+            const auto &job = jobs[i];
+            try {
+                lava::NetworkGenerator::generateNetwork(*job.config, job.outputFile, job.seed, threads);
+            } catch (...) {
+                std::lock_guard lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                next = jobs.size();
+                return;
+            }
+            std::lock_guard lock(mutex);
+            std::cout << "Generated network from " << job.configFile << " to " << job.outputFile << std::endl;
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < workers; t++) {
+        pool.emplace_back(work);
+    }
+    work();
+    for (auto &worker : pool) {
+        worker.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace
+
 int main(int argc, char *argv[])
 {
     try {
         auto args = ArgParser::parseGeneratorArgs(argc, argv);
+        const uint64_t seed = args.seed.value_or(std::random_device{}());
+        std::cout << "Seed: " << seed << std::endl;
 
+        // Network i of config c is drawn from its own stream: the files only depend on the seed
+        std::vector<lava::NetworkConfig> configs;
+        configs.reserve(args.configs.size());
         for (const auto &[configFile, nbNetworks] : args.configs) {
-            auto config = lava::NetworkConfig::fromFile(configFile);
-
+            configs.push_back(lava::NetworkConfig::fromFile(configFile));
+        }
+        std::vector<Job> jobs;
+        for (size_t c = 0; c < args.configs.size(); c++) {
+            const auto &[configFile, nbNetworks] = args.configs[c];
             std::string baseName = std::filesystem::path(configFile).stem().string();
+            const uint64_t configSeed = lava::Philox::derive(seed, c);
             for (int i = 1; i <= nbNetworks; i++) {
                 std::string outputFile = baseName + "_" + std::to_string(i) + ".nn";
-                std::cout << "Generating network " << i << " from " << configFile << " to " << outputFile << std::endl;
-                lava::NetworkGenerator::generateNetwork(config, outputFile);
+                jobs.push_back({&configs[c], configFile, outputFile, lava::Philox::derive(configSeed, i)});
             }
         }
+        generateAll(jobs);
         return 0;
     } catch (const std::exception &e) {
         std::cerr << "Error: " << e.what() << std::endl;
@@ -0,0 +1,204 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** Search
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <numbers>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "tuner/SearchSpace.hpp"
+
+namespace lava::tuner {
+
+/**
+ *  @brief A finished trial, as seen by the samplers.
+ */
+struct Observation {
+    std::vector<double> point; /** Unit hypercube coordinates */
+    size_t epochs{0}; /** Epochs trained before the end or the pruning of the trial */
+    double accuracy{0.0}; /** Validation accuracy after these epochs */
+
+    /**
+     *  @brief Trials going further are better, pruned trials only compete at the rung they reached.
+     */
+    bool betterThan(const Observation &other) const
+    {
+        return epochs != other.epochs ? epochs > other.epochs : accuracy > other.accuracy;
+    }
+};
+
+/**
+ *  @brief Picks the point of the next trial from the finished ones.
+ */
+class Search {
+    public:
+    virtual ~Search() = default;
+
+    virtual std::vector<double> suggest(const std::vector<Observation> &history, std::mt19937_64 &rng) = 0;
+
+    protected:
+    static std::vector<double> uniform(size_t dimensions, std::mt19937_64 &rng)
+    {
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+        std::vector<double> point(dimensions);
+        for (auto &u : point) {
+            u = dist(rng);
+        }
+        return point;
+    }
+};
+
+class RandomSearch : public Search {
+    public:
+    explicit RandomSearch(size_t dimensions) : _dimensions(dimensions) {}
+
+    std::vector<double> suggest(const std::vector<Observation> &, std::mt19937_64 &rng) override
+    {
+        return uniform(_dimensions, rng);
+    }
+
+    private:
+    size_t _dimensions;
+};
+
+/**
+ *  @brief Tree-structured Parzen estimator: the finished trials are split into the best GAMMA fraction and
+ *         the others, each modeled per coordinate by a mixture of truncated Gaussians. The candidate
+ *         maximizing l(x) / g(x), drawn from the best trials model l, is suggested.
+ *
+ *  NOTE: The coordinates are modeled independently, as Optuna does by default.
+ */
+class TpeSearch : public Search {
+    public:
+    static constexpr double GAMMA = 0.25;
+    static constexpr size_t CANDIDATES = 24;
+    static constexpr double MIN_BANDWIDTH = 0.01;
+
+    TpeSearch(size_t dimensions, size_t startupTrials) : _dimensions(dimensions), _startupTrials(startupTrials) {}
+
+    std::vector<double> suggest(const std::vector<Observation> &history, std::mt19937_64 &rng) override
+    {
+        if (history.size() < std::max<size_t>(_startupTrials, 2)) {
+            return uniform(_dimensions, rng);
+        }
+        std::vector<const Observation *> sorted;
+        for (const auto &observation : history) {
+            sorted.push_back(&observation);
+        }
+        std::sort(sorted.begin(), sorted.end(), [](const Observation *a, const Observation *b) {
+            return a->betterThan(*b);
+        });
+        size_t good = std::clamp<size_t>(static_cast<size_t>(std::ceil(GAMMA * sorted.size())), 1, sorted.size() - 1);
+
+        std::vector<Parzen> below;
+        std::vector<Parzen> above;
+        for (size_t d = 0; d < _dimensions; d++) {
+            below.emplace_back(sorted, 0, good, d);
+            above.emplace_back(sorted, good, sorted.size(), d);
+        }
+
+        std::vector<double> best;
+        double bestScore = -std::numeric_limits<double>::infinity();
+        for (size_t candidate = 0; candidate < CANDIDATES; candidate++) {
+            std::vector<double> point(_dimensions);
+            double score = 0;
+            for (size_t d = 0; d < _dimensions; d++) {
+                point[d] = below[d].sample(rng);
+                score += std::log(below[d].density(point[d])) - std::log(above[d].density(point[d]));
+            }
+            if (score > bestScore) {
+                bestScore = score;
+                best = std::move(point);
+            }
+        }
+        return best;
+    }
+
+    private:
+    /**
+     *  @brief Gaussians on [0, 1] centered on the observed coordinates, plus a wide prior one on the
+     *         middle so that no region has a zero density.
+     */
+    class Parzen {
+        public:
+        Parzen(const std::vector<const Observation *> &sorted, size_t begin, size_t end, size_t dimension)
+        {
+            for (size_t i = begin; i < end; i++) {
+                _centers.push_back(sorted[i]->point[dimension]);
+            }
+            // Scott's rule on the observations
+            double mean = 0;
+            for (double center : _centers) {
+                mean += center;
+            }
+            mean /= _centers.size();
+            double variance = 0;
+            for (double center : _centers) {
+                variance += (center - mean) * (center - mean);
+            }
+            double deviation = std::sqrt(variance / _centers.size());
+            _bandwidth = std::clamp(1.06 * deviation * std::pow(_centers.size(), -0.2), MIN_BANDWIDTH, 1.0);
+            _centers.push_back(0.5);
+        }
+
+        double density(double x) const
+        {
+            double total = 0;
+            for (size_t i = 0; i < _centers.size(); i++) {
+                total += truncatedNormal(x, _centers[i], i + 1 == _centers.size() ? 1.0 : _bandwidth);
+            }
+            return std::max(total / _centers.size(), std::numeric_limits<double>::min());
+        }
+
+        double sample(std::mt19937_64 &rng) const
+        {
+            size_t i = std::uniform_int_distribution<size_t>(0, _centers.size() - 1)(rng);
+            std::normal_distribution<double> dist(_centers[i], i + 1 == _centers.size() ? 1.0 : _bandwidth);
+            for (size_t attempt = 0; attempt < 64; attempt++) {
+                double x = dist(rng);
+                if (x >= 0 && x < 1) {
+                    return x;
+                }
+            }
+            return std::clamp(_centers[i], 0.0, std::nextafter(1.0, 0.0));
+        }
+
+        private:
+        static double truncatedNormal(double x, double mu, double sigma)
+        {
+            auto cdf = [&](double v) { return 0.5 * (1 + std::erf((v - mu) / (sigma * std::numbers::sqrt2))); };
+            double pdf = std::exp(-0.5 * (x - mu) * (x - mu) / (sigma * sigma)) /
+                (sigma * std::sqrt(2 * std::numbers::pi));
+            return pdf / (cdf(1.0) - cdf(0.0));
+        }
+
+        std::vector<double> _centers;
+        double _bandwidth{1.0};
+    };
+
+    size_t _dimensions;
+    size_t _startupTrials;
+};
+
+inline std::unique_ptr<Search> makeSearch(const TunerOptions &options, size_t dimensions)
+{
+    if (options.sampler == "random") {
+        return std::make_unique<RandomSearch>(dimensions);
+    }
+    if (options.sampler == "tpe") {
+        return std::make_unique<TpeSearch>(dimensions, options.startupTrials);
+    }
+    throw std::runtime_error("Unknown tuner sampler: " + options.sampler + " (expected random or tpe)");
+}
+
+} // namespace lava::tuner
@@ -0,0 +1,364 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** SearchSpace
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace lava::tuner {
+
+/**
+ *  @brief The [tuner] section of a search file.
+ */
+struct TunerOptions {
+    size_t trials{32};
+    size_t parallel{1}; /** Trials trained at the same time, each on its share of the hardware threads */
+    std::string sampler{"tpe"}; /** random or tpe */
+    size_t startupTrials{8}; /** Random trials before the TPE sampler models the results */
+    size_t minEpochs{2}; /** First rung of successive halving */
+    size_t maxEpochs{20};
+    size_t reductionFactor{3}; /** One trial in reductionFactor goes on at each rung, 1 disables pruning */
+    double validationSplit{0.2}; /** Fraction of the dataset held out to score the trials */
+    std::optional<uint64_t> seed;
+    std::string output{"examples/best_network.conf"}; /** Configuration of the best trial */
+    std::string report{"hyperparameter_optimization_report.json"};
+};
+
+/**
+ *  @brief One tuned key of the network configuration, written `section.key=kind arguments` in the
+ *         [search] section:
+ *
+ *  - `float LOW HIGH` and `log LOW HIGH`: uniform in the range, or in the logarithm of the range
+ *  - `int LOW HIGH [STEP]`
+ *  - `choice VALUE...`
+ *  - `layers MIN_COUNT MAX_COUNT MIN_SIZE MAX_SIZE` (architecture.hidden_sizes only): a number of hidden
+ *    layers with power of 2 sizes, each layer at most as wide as the previous one
+ *
+ *  Samplers work in the unit hypercube: a parameter spans dimensions() coordinates in [0, 1), decoded
+ *  into configuration values.
+ */
+struct Parameter {
+    enum class Kind {
+        FLOAT,
+        LOG,
+        INT,
+        CHOICE,
+        LAYERS
+    };
+
+    std::string section;
+    std::string key;
+    std::string name; /** Name in the report */
+    Kind kind{Kind::FLOAT};
+    double low{0};
+    double high{0};
+    double step{1};
+    std::vector<std::string> choices; /** Values of a choice, power of 2 sizes of layers */
+
+    size_t dimensions() const
+    {
+        // The layer count, then the size of every possible layer
+        return kind == Kind::LAYERS ? 1 + static_cast<size_t>(high) : 1;
+    }
+};
+
+/**
+ *  @brief Configuration lines and report values of a point of the search space.
+ */
+struct Assignment {
+    std::string overrides; /** `.conf` lines applied on top of the base configuration */
+    std::vector<std::pair<std::string, std::string>> params; /** Report name and JSON value */
+};
+
+class SearchSpace {
+    public:
+    static SearchSpace fromFile(const std::string &filename)
+    {
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open search file: " + filename);
+        }
+
+        SearchSpace space;
+        std::string line;
+        std::string section;
+        while (std::getline(file, line)) {
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            if (line[0] == '[') {
+                section = line.substr(1, line.find(']') - 1);
+                continue;
+            }
+            auto pos = line.find('=');
+            if (pos == std::string::npos) {
+                continue;
+            }
+            if (section == "tuner") {
+                space._parseOption(line.substr(0, pos), line.substr(pos + 1));
+            } else if (section == "search") {
+                space._parameters.push_back(_parseParameter(line.substr(0, pos), line.substr(pos + 1)));
+            }
+        }
+        space._validate();
+        return space;
+    }
+
+    const TunerOptions &options() const
+    {
+        return _options;
+    }
+
+    const std::vector<Parameter> &parameters() const
+    {
+        return _parameters;
+    }
+
+    size_t dimensions() const
+    {
+        size_t total = 0;
+        for (const auto &parameter : _parameters) {
+            total += parameter.dimensions();
+        }
+        return total;
+    }
+
+    /**
+     *  @brief Decodes the unit hypercube coordinates @param point.
+     */
+    Assignment decode(const std::vector<double> &point) const
+    {
+        Assignment assignment;
+        std::string section;
+        size_t offset = 0;
+        for (const auto &parameter : _parameters) {
+            if (parameter.section != section) {
+                section = parameter.section;
+                assignment.overrides += "[" + section + "]\n";
+            }
+            const double *u = point.data() + offset;
+            offset += parameter.dimensions();
+
+            switch (parameter.kind) {
+                case Parameter::Kind::FLOAT:
+                case Parameter::Kind::LOG: {
+                    double value = parameter.kind == Parameter::Kind::FLOAT
+                        ? parameter.low + u[0] * (parameter.high - parameter.low)
+                        : std::exp(std::log(parameter.low) + u[0] * std::log(parameter.high / parameter.low));
+                    assignment.overrides += parameter.key + "=" + _number(value) + "\n";
+                    assignment.params.emplace_back(parameter.name, _number(value));
+                    break;
+                }
+                case Parameter::Kind::INT: {
+                    size_t count = static_cast<size_t>((parameter.high - parameter.low) / parameter.step) + 1;
+                    auto value = static_cast<int64_t>(parameter.low + _index(u[0], count) * parameter.step);
+                    assignment.overrides += parameter.key + "=" + std::to_string(value) + "\n";
+                    assignment.params.emplace_back(parameter.name, std::to_string(value));
+                    break;
+                }
+                case Parameter::Kind::CHOICE: {
+                    const auto &value = parameter.choices[_index(u[0], parameter.choices.size())];
+                    assignment.overrides += parameter.key + "=" + value + "\n";
+                    assignment.params.emplace_back(parameter.name, "\"" + value + "\"");
+                    break;
+                }
+                case Parameter::Kind::LAYERS: {
+                    auto minCount = static_cast<size_t>(parameter.low);
+                    size_t count = minCount + _index(u[0], static_cast<size_t>(parameter.high) - minCount + 1);
+                    assignment.params.emplace_back("n_hidden_layers", std::to_string(count));
+                    std::string sizes;
+                    size_t widest = parameter.choices.size();
+                    for (size_t i = 0; i < count; i++) {
+                        widest = _index(u[1 + i], widest) + 1;
+                        const auto &size = parameter.choices[widest - 1];
+                        sizes += (i ? "," : "") + size;
+                        assignment.params.emplace_back("hidden_size_" + std::to_string(i), size);
+                    }
+                    assignment.overrides += "hidden_layers=" + std::to_string(count) + "\n";
+                    assignment.overrides += "hidden_sizes=" + sizes + "\n";
+                    break;
+                }
+            }
+        }
+        return assignment;
+    }
+
+    private:
+    TunerOptions _options;
+    std::vector<Parameter> _parameters;
+
+    static size_t _index(double u, size_t count)
+    {
+        return std::min(count - 1, static_cast<size_t>(u * count));
+    }
+
+    static std::string _number(double value)
+    {
+        std::ostringstream out;
+        out << std::setprecision(std::numeric_limits<double>::max_digits10) << value;
+        return out.str();
+    }
+
+    void _parseOption(const std::string &key, const std::string &value)
+    {
+        if (key == "trials") {
+            _options.trials = std::stoul(value);
+        } else if (key == "parallel") {
+            _options.parallel = std::stoul(value);
+        } else if (key == "sampler") {
+            _options.sampler = value;
+        } else if (key == "startup_trials") {
+            _options.startupTrials = std::stoul(value);
+        } else if (key == "min_epochs") {
+            _options.minEpochs = std::stoul(value);
+        } else if (key == "max_epochs") {
+            _options.maxEpochs = std::stoul(value);
+        } else if (key == "reduction_factor") {
+            _options.reductionFactor = std::stoul(value);
+        } else if (key == "validation_split") {
+            _options.validationSplit = std::stod(value);
+        } else if (key == "seed") {
+            _options.seed = std::stoull(value);
+        } else if (key == "output") {
+            _options.output = value;
+        } else if (key == "report") {
+            _options.report = value;
+        }
+    }
+
+    static Parameter _parseParameter(const std::string &name, const std::string &spec)
+    {
+        auto invalid = [&](const std::string &reason) {
+            return std::runtime_error("Invalid search parameter " + name + "=" + spec + ": " + reason);
+        };
+        Parameter parameter;
+        auto dot = name.find('.');
+        if (dot == std::string::npos) {
+            throw invalid("expected section.key");
+        }
+        parameter.section = name.substr(0, dot);
+        parameter.key = name.substr(dot + 1);
+        parameter.name = parameter.key;
+
+        std::istringstream in(spec);
+        std::string kind;
+        in >> kind;
+        std::vector<std::string> args;
+        for (std::string arg; in >> arg;) {
+            args.push_back(arg);
+        }
+        auto number = [&](size_t i) {
+            try {
+                return std::stod(args[i]);
+            } catch (const std::exception &) {
+                throw invalid("expected a number, got " + args[i]);
+            }
+        };
+
+        if (kind == "float" || kind == "log") {
+            parameter.kind = kind == "float" ? Parameter::Kind::FLOAT : Parameter::Kind::LOG;
+            if (args.size() != 2) {
+                throw invalid("expected LOW HIGH");
+            }
+            parameter.low = number(0);
+            parameter.high = number(1);
+            if (parameter.kind == Parameter::Kind::LOG && parameter.low <= 0) {
+                throw invalid("a log range must be positive");
+            }
+        } else if (kind == "int") {
+            parameter.kind = Parameter::Kind::INT;
+            if (args.size() != 2 && args.size() != 3) {
+                throw invalid("expected LOW HIGH [STEP]");
+            }
+            parameter.low = number(0);
+            parameter.high = number(1);
+            parameter.step = args.size() == 3 ? number(2) : 1;
+            if (parameter.step < 1 || parameter.low != std::floor(parameter.low) ||
+                parameter.step != std::floor(parameter.step)) {
+                throw invalid("expected integers and a positive step");
+            }
+        } else if (kind == "choice") {
+            parameter.kind = Parameter::Kind::CHOICE;
+            if (args.empty()) {
+                throw invalid("expected at least one value");
+            }
+            parameter.choices = args;
+        } else if (kind == "layers") {
+            parameter.kind = Parameter::Kind::LAYERS;
+            if (name != "architecture.hidden_sizes") {
+                throw invalid("layers only applies to architecture.hidden_sizes");
+            }
+            if (args.size() != 4) {
+                throw invalid("expected MIN_COUNT MAX_COUNT MIN_SIZE MAX_SIZE");
+            }
+            parameter.low = number(0);
+            parameter.high = number(1);
+            for (double size = 1; size <= number(3); size *= 2) {
+                if (size >= number(2)) {
+                    parameter.choices.push_back(std::to_string(static_cast<size_t>(size)));
+                }
+            }
+            if (parameter.low < 1 || parameter.choices.empty()) {
+                throw invalid("expected at least one layer and a power of 2 between the sizes");
+            }
+        } else {
+            throw invalid("unknown kind " + kind + " (expected float, log, int, choice or layers)");
+        }
+        if (parameter.high < parameter.low) {
+            throw invalid("empty range");
+        }
+        return parameter;
+    }
+
+    void _validate()
+    {
+        if (_parameters.empty()) {
+            throw std::runtime_error("The search file has no [search] parameter");
+        }
+        // Keys shared by several sections (eg. type) are reported with their section
+        for (auto &parameter : _parameters) {
+            auto count = std::count_if(_parameters.begin(), _parameters.end(), [&](const Parameter &other) {
+                return other.key == parameter.key;
+            });
+            if (count > 1) {
+                parameter.name = parameter.section + "_" + parameter.key;
+            }
+        }
+        std::stable_sort(_parameters.begin(), _parameters.end(), [](const Parameter &a, const Parameter &b) {
+            return a.section < b.section;
+        });
+
+        if (_options.trials == 0 || _options.parallel == 0) {
+            throw std::runtime_error("The tuner needs at least one trial and one parallel trial");
+        }
+        if (_options.sampler != "random" && _options.sampler != "tpe") {
+            throw std::runtime_error("Invalid tuner sampler (must be random or tpe)");
+        }
+        if (_options.minEpochs == 0 || _options.maxEpochs < _options.minEpochs) {
+            throw std::runtime_error("The tuner epochs must satisfy 0 < min_epochs <= max_epochs");
+        }
+        if (_options.reductionFactor == 0) {
+            throw std::runtime_error("The reduction factor must be greater than 0");
+        }
+        if (_options.validationSplit <= 0 || _options.validationSplit >= 1) {
+            throw std::runtime_error("The tuner validation split must be between 0 and 1");
+        }
+    }
+};
+
+} // namespace lava::tuner
@@ -0,0 +1,90 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** SuccessiveHalving
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace lava::tuner {
+
+/**
+ *  @brief Asynchronous successive halving (ASHA): the trials are scored at rungs of minEpochs,
+ *         minEpochs * eta, minEpochs * eta^2, ... epochs and only the best 1 / eta of the scores recorded
+ *         at a rung go on.
+ *
+ *  A trial is compared with the trials which reached the rung before it, so no trial waits for the others:
+ *  the first ones are never pruned, the bar rises as the rungs fill up.
+ *
+ *  NOTE: Thread-safe, the trials report from their own threads.
+ */
+class SuccessiveHalving {
+    public:
+    /**
+     *  @param reductionFactor eta, 1 disables the pruning
+     */
+    SuccessiveHalving(size_t minEpochs, size_t maxEpochs, size_t reductionFactor) : _reductionFactor(reductionFactor)
+    {
+        for (size_t epoch = minEpochs; epoch < maxEpochs && reductionFactor > 1; epoch *= reductionFactor) {
+            _rungs.push_back({epoch, {}});
+        }
+    }
+
+    /**
+     *  @return Epochs of the rungs, the last epoch of the training is not one.
+     */
+    std::vector<size_t> rungs() const
+    {
+        std::vector<size_t> epochs;
+        for (const auto &rung : _rungs) {
+            epochs.push_back(rung.epoch);
+        }
+        return epochs;
+    }
+
+    /**
+     *  @return True when @param epoch is a rung, at which the trials are scored.
+     */
+    bool isRung(size_t epoch) const
+    {
+        return std::any_of(_rungs.begin(), _rungs.end(), [&](const Rung &rung) { return rung.epoch == epoch; });
+    }
+
+    /**
+     *  @brief Records the @param accuracy of a trial at the rung @param epoch.
+     *
+     *  @return False when the trial is pruned.
+     */
+    bool report(size_t epoch, double accuracy)
+    {
+        std::lock_guard lock(_mutex);
+        auto rung = std::find_if(_rungs.begin(), _rungs.end(), [&](const Rung &r) { return r.epoch == epoch; });
+        if (rung == _rungs.end()) {
+            return true;
+        }
+        rung->scores.push_back(accuracy);
+        size_t promoted = std::max<size_t>(1, rung->scores.size() / _reductionFactor);
+        auto better = std::count_if(rung->scores.begin(), rung->scores.end(), [&](double score) {
+            return score > accuracy;
+        });
+        return static_cast<size_t>(better) < promoted;
+    }
+
+    private:
+    struct Rung {
+        size_t epoch;
+        std::vector<double> scores;
+    };
+
+    size_t _reductionFactor;
+    std::vector<Rung> _rungs;
+    std::mutex _mutex;
+};
+
+} // namespace lava::tuner
@@ -0,0 +1,249 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** Tuner
+*/
+
+#include "tuner/Tuner.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include "generator/NetworkGenerator.hpp"
+#include "training/Validator.hpp"
+#include "training/chessTraining.hpp"
+
+namespace lava::tuner {
+
+Tuner::Tuner(SearchSpace space, NetworkConfig base, const std::vector<ChessboardParser::ChessboardData> &datas) :
+    _space(std::move(space)),
+    _options(_space.options()),
+    _base(std::move(base)),
+    _halving(_options.minEpochs, _options.maxEpochs, _options.reductionFactor),
+    _search(makeSearch(_options, _space.dimensions())),
+    _rng(_options.seed.value_or(std::random_device{}()))
+{
+    // The same positions score every trial
+    std::vector<size_t> indices(datas.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    std::shuffle(indices.begin(), indices.end(), _rng);
+    size_t count = static_cast<size_t>(_options.validationSplit * datas.size());
+    if (count == 0 || count == datas.size()) {
+        throw std::runtime_error("The tuner validation split must leave positions for training and validation");
+    }
+    for (size_t i = 0; i < indices.size(); i++) {
+        (i < count ? _validation : _train).push_back(datas[indices[i]]);
+    }
+    for (const auto &board : _validation) {
+        _validationLabels.push_back(train::getLabelIndex(board.expectedOutput));
+    }
+
+    unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+    _options.parallel = std::min(_options.parallel, _options.trials);
+    _threadsPerTrial = std::max<size_t>(1, threads / _options.parallel);
+}
+
+void Tuner::run()
+{
+    std::cout << "Tuning " << _options.trials << " trials with the " << _options.sampler << " sampler, "
+              << _options.parallel << " at a time on " << _threadsPerTrial << " threads each" << std::endl;
+    std::cout << "Positions: " << _train.size() << " training, " << _validation.size() << " validation"
+              << std::endl;
+    std::cout << "Epochs: " << _options.maxEpochs << ", successive halving rungs:";
+    for (size_t epoch : _halving.rungs()) {
+        std::cout << " " << epoch;
+    }
+    std::cout << (_halving.rungs().empty() ? " none" : "") << std::endl;
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < _options.parallel; i++) {
+        workers.emplace_back(&Tuner::_worker, this);
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    const auto *best = _best();
+    if (!best) {
+        throw std::runtime_error("No trial completed");
+    }
+    std::ofstream output(_options.output);
+    output << best->config;
+    if (!output) {
+        throw std::runtime_error("Could not write the best configuration: " + _options.output);
+    }
+    _writeReport();
+
+    std::cout << "\nBest trial: " << best->trial + 1 << " - Accuracy: " << std::fixed << std::setprecision(2)
+              << best->observation.accuracy * 100 << "%" << std::endl;
+    for (const auto &[name, value] : best->assignment.params) {
+        std::cout << "  " << name << ": " << value << std::endl;
+    }
+    std::cout << "Best configuration saved to " << _options.output << std::endl;
+    std::cout << "Report saved to " << _options.report << std::endl;
+}
+
+void Tuner::_worker()
+{
+    while (true) {
+        size_t trial = 0;
+        std::vector<double> point;
+        uint64_t seed = 0;
+        {
+            std::lock_guard lock(_mutex);
+            if (_nextTrial >= _options.trials) {
+                return;
+            }
+            trial = _nextTrial++;
+            point = _search->suggest(_history, _rng);
+            seed = _rng();
+        }
+        _record(_runTrial(trial, point, seed));
+    }
+}
+
+TrialResult Tuner::_runTrial(size_t trial, const std::vector<double> &point, uint64_t seed)
+{
+    TrialResult result;
+    result.trial = trial;
+    result.assignment = _space.decode(point);
+    result.observation.point = point;
+    auto start = std::chrono::steady_clock::now();
+    try {
+        auto config = NetworkConfig::fromString(_base.toString() + "\n" + result.assignment.overrides);
+        result.config = config.toString();
+        if (config.architecture().dtype == DataType::FLOAT32) {
+            _trainTrial<float>(config, seed, result);
+        } else {
+            _trainTrial<double>(config, seed, result);
+        }
+    } catch (const std::exception &e) {
+        result.error = e.what();
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+template <typename T>
+void Tuner::_trainTrial(const NetworkConfig &config, uint64_t seed, TrialResult &result)
+{
+    auto network = NetworkGenerator::buildNetwork<T>(config, seed);
+    std::vector<size_t> indices(_validation.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    train::Validator<T> validator(_validation, std::move(indices), _validationLabels);
+
+    // The tuner holds out and scores the positions itself, nothing is saved
+    auto training = train::makeTrainingConfig(config);
+    training.epochs = _options.maxEpochs;
+    training.validation = train::ValidationOptions{};
+    training.shouldSave = false;
+    training.seed = seed;
+    training.threads = _threadsPerTrial;
+    training.quiet = true;
+    training.onEpoch = [&](train::EpochControl &control) {
+        const size_t epoch = control.epoch;
+        if (epoch != _options.maxEpochs && !_halving.isRung(epoch)) {
+            return true;
+        }
+        validator.submit(*network, epoch);
+        result.observation.epochs = epoch;
+        result.observation.accuracy = validator.finish()->accuracy;
+        result.pruned = !_halving.report(epoch, result.observation.accuracy);
+        return !result.pruned;
+    };
+    train::chessTrain(*network, _train, training);
+}
+
+void Tuner::_record(TrialResult result)
+{
+    std::lock_guard lock(_mutex);
+    std::cout << "Trial " << result.trial + 1 << "/" << _options.trials;
+    if (result.error.empty()) {
+        std::cout << " - Accuracy: " << std::fixed << std::setprecision(2) << result.observation.accuracy * 100
+                  << "% after " << result.observation.epochs << "/" << _options.maxEpochs << " epochs"
+                  << (result.pruned ? " (pruned)" : "");
+        _history.push_back(result.observation);
+    } else {
+        std::cout << " - Failed: " << result.error;
+    }
+    std::cout << " - " << std::setprecision(1) << result.seconds << "s -";
+    for (const auto &[name, value] : result.assignment.params) {
+        std::cout << " " << name << "=" << value;
+    }
+    std::cout << std::endl;
+    _results.push_back(std::move(result));
+
+    if (const auto *best = _best()) {
+        std::cout << "  Best: " << std::setprecision(2) << best->observation.accuracy * 100 << "% (trial "
+                  << best->trial + 1 << ")" << std::endl;
+    }
+}
+
+const TrialResult *Tuner::_best() const
+{
+    const TrialResult *best = nullptr;
+    for (const auto &result : _results) {
+        if (result.error.empty() && (!best || result.observation.betterThan(best->observation))) {
+            best = &result;
+        }
+    }
+    return best;
+}
+
+void Tuner::_writeReport() const
+{
+    auto params = [](const Assignment &assignment) {
+        std::string json = "{";
+        for (const auto &[name, value] : assignment.params) {
+            json += (json.size() > 1 ? ", \"" : "\"") + name + "\": " + value;
+        }
+        return json + "}";
+    };
+    std::vector<const TrialResult *> trained;
+    for (const auto &result : _results) {
+        if (result.error.empty()) {
+            trained.push_back(&result);
+        }
+    }
+    std::sort(trained.begin(), trained.end(), [](const TrialResult *a, const TrialResult *b) {
+        return a->trial < b->trial;
+    });
+
+    std::ofstream out(_options.report);
+    if (!out.is_open()) {
+        throw std::runtime_error("Could not open the report file: " + _options.report);
+    }
+    const auto *best = _best();
+    out << std::setprecision(6);
+    out << "{\n  \"best_accuracy\": " << best->observation.accuracy * 100 << ",\n";
+    out << "  \"best_params\": " << params(best->assignment) << ",\n";
+    out << "  \"n_trials\": " << _options.trials << ",\n";
+    out << "  \"optimization_history\": [";
+    for (size_t i = 0; i < trained.size(); i++) {
+        const auto &result = *trained[i];
+        out << (i ? ",\n" : "\n") << "    {\"trial\": " << result.trial << ", \"accuracy\": "
+            << result.observation.accuracy * 100 << ", \"epochs\": " << result.observation.epochs
+            << ", \"pruned\": " << (result.pruned ? "true" : "false") << ", \"seconds\": " << result.seconds
+            << ", \"params\": " << params(result.assignment) << "}";
+    }
+    auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    out << "\n  ],\n  \"importance\": null,\n";
+    out << "  \"system_info\": {\"date\": \"" << std::put_time(std::localtime(&now), "%Y-%m-%d %H:%M:%S")
+        << "\", \"sampler\": \"" << _options.sampler << "\", \"parallel\": " << _options.parallel
+        << ", \"threads_per_trial\": " << _threadsPerTrial << ", \"max_epochs\": " << _options.maxEpochs
+        << ", \"reduction_factor\": " << _options.reductionFactor << "}\n}\n";
+    if (!out) {
+        throw std::runtime_error("Could not write the report file: " + _options.report);
+    }
+}
+
+} // namespace lava::tuner
@@ -0,0 +1,79 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** Tuner
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+#include "ChessboardParser.hpp"
+#include "tuner/Search.hpp"
+#include "tuner/SearchSpace.hpp"
+#include "tuner/SuccessiveHalving.hpp"
+#include "utils/NetworkConfig.hpp"
+
+namespace lava::tuner {
+
+struct TrialResult {
+    size_t trial{0};
+    Assignment assignment;
+    std::string config; /** Full `.conf` text of the trial */
+    Observation observation;
+    bool pruned{false};
+    std::string error; /** Why the trial failed, empty when it trained */
+    double seconds{0.0};
+};
+
+/**
+ *  @brief Runs the trials of a search space in one process.
+ *
+ *  The dataset is split once into training and validation positions, shared read-only by every trial.
+ *  Up to `parallel` trials train at the same time, each on its share of the hardware threads, and are
+ *  scored on the validation positions at the successive halving rungs and after their last epoch.
+ */
+class Tuner {
+    public:
+    Tuner(SearchSpace space, NetworkConfig base, const std::vector<ChessboardParser::ChessboardData> &datas);
+
+    /**
+     *  @brief Runs every trial, then writes the best configuration and the JSON report.
+     */
+    void run();
+
+    private:
+    void _worker();
+    TrialResult _runTrial(size_t trial, const std::vector<double> &point, uint64_t seed);
+
+    template <typename T>
+    void _trainTrial(const NetworkConfig &config, uint64_t seed, TrialResult &result);
+
+    void _record(TrialResult result);
+    const TrialResult *_best() const;
+    void _writeReport() const;
+
+    SearchSpace _space;
+    TunerOptions _options;
+    NetworkConfig _base;
+    std::vector<ChessboardParser::ChessboardData> _train;
+    std::vector<ChessboardParser::ChessboardData> _validation;
+    std::vector<size_t> _validationLabels;
+    size_t _threadsPerTrial{1};
+    SuccessiveHalving _halving;
+
+    // Guarded by _mutex: the sampler reads the history of the finished trials
+    std::mutex _mutex;
+    std::unique_ptr<Search> _search;
+    std::mt19937_64 _rng;
+    size_t _nextTrial{0};
+    std::vector<Observation> _history;
+    std::vector<TrialResult> _results;
+};
+
+} // namespace lava::tuner
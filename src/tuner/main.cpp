@@ -0,0 +1,30 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** main
+*/
+
+#include <iostream>
+#include "ArgParser.hpp"
+#include "ChessboardParser.hpp"
+#include "tuner/SearchSpace.hpp"
+#include "tuner/Tuner.hpp"
+#include "utils/NetworkConfig.hpp"
+
+int main(int argc, char *argv[])
+{
+    try {
+        auto args = ArgParser::parseTunerArgs(argc, argv);
+        auto space = lava::tuner::SearchSpace::fromFile(args.searchFile);
+        auto base = lava::NetworkConfig::fromFile(args.configFile);
+        auto datas = ChessboardParser::parseChessboardFile(args.datasetFile);
+
+        lava::tuner::Tuner tuner(std::move(space), std::move(base), datas);
+        tuner.run();
+        return 0;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 84;
+    }
+}
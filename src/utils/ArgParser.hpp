@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <cstdint>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -15,25 +17,65 @@ class ArgParser {
     public:
     struct GeneratorArgs {
         std::vector<std::pair<std::string, int>> configs;
+        std::optional<uint64_t> seed; /** Every network is drawn from it, a random one is printed when unset */
     };
 
     struct AnalyzerArgs {
         bool isPredictMode{};
         bool isTrainMode{};
+        bool isConvertMode{};
+        std::string convertType;
+        bool isQuantizeMode{};
+        std::string testFile;
         std::string loadFile;
         std::string inputFile;
         std::string saveFile;
+        size_t rank{0};
+        size_t worldSize{1};
+        std::string transport{"tcp"};
+        std::string distAddress;
+        std::optional<uint64_t> seed;
+        bool resume{};
+        std::string profileFile; /** Chrome trace written when set, with a per-op table on the error output */
+        std::string telemetryFile; /** Per-epoch training metrics, one JSON object per line */
+        bool isPopulationMode{};
+        std::vector<std::string> populationFiles; /** Networks of the population, loadFile is the first one */
+        size_t populationInterval{5}; /** Epochs between two exploit and explore steps */
+        double populationFraction{0.25}; /** Worst fraction replaced by copies of the best one */
+    };
+
+    struct BenchArgs {
+        std::string configFile{"examples/basic_network.conf"}; /** Layer sizes and data type of the network */
+        std::string datasetFile; /** Positions used for the predict and training cases, built-in ones if empty */
+        std::string outputFile; /** JSON report, written on the standard output if empty */
+        double minSeconds{0.5}; /** Minimum timed duration of each case */
+        std::string filter; /** Only the cases whose name contains it run */
+    };
+
+    struct TunerArgs {
+        std::string searchFile; /** Search space and [tuner] options */
+        std::string configFile; /** Base configuration, the searched keys are overridden */
+        std::string datasetFile;
     };
 
     static GeneratorArgs parseGeneratorArgs(int argc, char *argv[])
     {
-        if (argc < 3 || (argc % 2) != 1) {
-            throw std::runtime_error("Invalid number of arguments\nUSAGE: ./my_torch_generator "
+        GeneratorArgs args;
+        int i = 1;
+        if (i + 1 < argc && std::string(argv[i]) == "--seed") {
+            try {
+                args.seed = std::stoull(argv[i + 1]);
+            } catch (const std::exception &) {
+                throw std::runtime_error("--seed expects a number");
+            }
+            i += 2;
+        }
+        if (argc - i < 2 || (argc - i) % 2 != 0) {
+            throw std::runtime_error("Invalid number of arguments\nUSAGE: ./my_torch_generator [--seed N] "
                                      "config_file_1 nb_1 [config_file_2 nb_2...]");
         }
 
-        GeneratorArgs args;
-        for (int i = 1; i < argc; i += 2) {
+        for (; i < argc; i += 2) {
             std::string configFile = argv[i];
             int nbNetworks = 0;
             try {
@@ -53,7 +95,13 @@ class ArgParser {
     {
         if (argc < 4) {
             throw std::runtime_error("Invalid number of arguments\nUSAGE: ./my_torch_analyzer [--predict "
-                                     "| --train [--save SAVEFILE]] LOADFILE FILE");
+                                     "| --train [--save SAVEFILE] [--resume] [--seed N] [--rank R --world-size N "
+                                     "[--transport tcp|shm] [--dist-addr ADDR]] [--telemetry FILE.jsonl]] "
+                                     "[--profile TRACE.json] LOADFILE FILE\n"
+                                     "       ./my_torch_analyzer --pbt [--save SAVEFILE] [--seed N] "
+                                     "[--interval EPOCHS] [--fraction F] LOADFILE LOADFILE... FILE\n"
+                                     "       ./my_torch_analyzer --convert float32|float64 LOADFILE SAVEFILE\n"
+                                     "       ./my_torch_analyzer --quantize LOADFILE CALIBFILE SAVEFILE [TESTFILE]");
         }
 
         AnalyzerArgs args;
@@ -65,15 +113,42 @@ class ArgParser {
         if (std::string(argv[i]) == "--predict") {
             args.isPredictMode = true;
             i++;
+            if (i + 3 < argc && std::string(argv[i]) == "--profile") {
+                args.profileFile = argv[i + 1];
+                i += 2;
+            }
         } else if (std::string(argv[i]) == "--train") {
             args.isTrainMode = true;
             i++;
-            if (i + 2 < argc && std::string(argv[i]) == "--save") {
-                args.saveFile = argv[i + 1];
-                i += 2;
+            i = parseTrainOptions(argc, argv, i, args);
+        } else if (std::string(argv[i]) == "--pbt") {
+            args.isPopulationMode = true;
+            parsePopulationArgs(argc, argv, i + 1, args);
+            return args;
+        } else if (std::string(argv[i]) == "--convert") {
+            args.isConvertMode = true;
+            args.convertType = argv[i + 1];
+            if (args.convertType != "float32" && args.convertType != "float64") {
+                throw std::runtime_error("--convert expects float32 or float64");
             }
+            if (i + 3 >= argc) {
+                throw std::runtime_error("Missing LOADFILE or SAVEFILE argument");
+            }
+            args.loadFile = argv[i + 2];
+            args.saveFile = argv[i + 3];
+            return args;
+        } else if (std::string(argv[i]) == "--quantize") {
+            args.isQuantizeMode = true;
+            if (i + 3 >= argc) {
+                throw std::runtime_error("Missing LOADFILE, CALIBFILE or SAVEFILE argument");
+            }
+            args.loadFile = argv[i + 1];
+            args.inputFile = argv[i + 2];
+            args.saveFile = argv[i + 3];
+            args.testFile = (i + 4 < argc) ? argv[i + 4] : args.inputFile;
+            return args;
         } else {
-            throw std::runtime_error("Must specify either --predict or --train mode");
+            throw std::runtime_error("Must specify either --predict, --train, --pbt, --convert or --quantize mode");
         }
 
         if (i + 1 >= argc) {
@@ -85,4 +160,153 @@ class ArgParser {
 
         return args;
     }
+
+    static BenchArgs parseBenchArgs(int argc, char *argv[])
+    {
+        BenchArgs args;
+        int i = 1;
+        for (; i < argc && std::string(argv[i]).starts_with("--"); i += 2) {
+            std::string option = argv[i];
+            if (option != "--output" && option != "--filter" && option != "--min-time") {
+                throw std::runtime_error(
+                    "Unknown option: " + option + "\nUSAGE: ./my_torch_bench [--output FILE.json] [--min-time "
+                    "SECONDS] [--filter NAME] [CONFIG [DATASET]]"
+                );
+            }
+            if (i + 1 >= argc) {
+                throw std::runtime_error("Missing value of " + option);
+            }
+            const char *value = argv[i + 1];
+            if (option == "--output") {
+                args.outputFile = value;
+            } else if (option == "--filter") {
+                args.filter = value;
+            } else if (option == "--min-time") {
+                try {
+                    args.minSeconds = std::stod(value);
+                } catch (const std::exception &) {
+                    throw std::runtime_error("--min-time expects a number of seconds");
+                }
+                if (args.minSeconds < 0) {
+                    throw std::runtime_error("--min-time expects a number of seconds");
+                }
+            }
+        }
+        if (i < argc) {
+            args.configFile = argv[i++];
+        }
+        if (i < argc) {
+            args.datasetFile = argv[i++];
+        }
+        if (i < argc) {
+            throw std::runtime_error("Too many arguments\nUSAGE: ./my_torch_bench [--output FILE.json] [--min-time "
+                                     "SECONDS] [--filter NAME] [CONFIG [DATASET]]");
+        }
+        return args;
+    }
+
+    static TunerArgs parseTunerArgs(int argc, char *argv[])
+    {
+        if (argc != 4) {
+            throw std::runtime_error("Invalid number of arguments\nUSAGE: ./my_torch_tuner SEARCH_FILE BASE_CONFIG "
+                                     "DATASET");
+        }
+        return TunerArgs{argv[1], argv[2], argv[3]};
+    }
+
+    private:
+    /**
+     *  @brief Parses the options and the files following --pbt from @param i: the networks of the population,
+     *         then the training positions.
+     */
+    static void parsePopulationArgs(int argc, char *argv[], int i, AnalyzerArgs &args)
+    {
+        for (; i < argc && std::string(argv[i]).starts_with("--"); i += 2) {
+            std::string option = argv[i];
+            if (i + 1 >= argc) {
+                throw std::runtime_error("Missing value of " + option);
+            }
+            const char *value = argv[i + 1];
+            try {
+                if (option == "--save") {
+                    args.saveFile = value;
+                } else if (option == "--seed") {
+                    args.seed = std::stoull(value);
+                } else if (option == "--interval") {
+                    args.populationInterval = std::stoul(value);
+                } else if (option == "--fraction") {
+                    args.populationFraction = std::stod(value);
+                } else {
+                    throw std::runtime_error("Unknown population option: " + option);
+                }
+            } catch (const std::logic_error &) {
+                throw std::runtime_error(option + " expects a number");
+            }
+        }
+        if (argc - i < 3) {
+            throw std::runtime_error("--pbt needs at least two LOADFILE arguments and a FILE argument");
+        }
+        args.populationFiles.assign(argv + i, argv + argc - 1);
+        args.loadFile = args.populationFiles.front();
+        args.inputFile = argv[argc - 1];
+    }
+
+    /**
+     *  @brief Parses the options following --train from @param i, up to LOADFILE and FILE.
+     *
+     *  @return Index of LOADFILE.
+     */
+    static int parseTrainOptions(int argc, char *argv[], int i, AnalyzerArgs &args)
+    {
+        auto number = [](const std::string &option, const char *value) {
+            try {
+                size_t pos = 0;
+                unsigned long long parsed = std::stoull(value, &pos);
+                if (pos != std::string(value).size()) {
+                    throw std::invalid_argument(value);
+                }
+                return static_cast<uint64_t>(parsed);
+            } catch (const std::exception &) {
+                throw std::runtime_error(option + " expects a non-negative integer");
+            }
+        };
+
+        // The last two arguments are LOADFILE and FILE
+        while (i + 2 < argc && std::string(argv[i]).starts_with("--")) {
+            std::string option = argv[i];
+            if (option == "--resume") {
+                args.resume = true;
+                i++;
+                continue;
+            }
+            if (i + 3 >= argc) {
+                throw std::runtime_error("Missing value of " + option + " or LOADFILE and FILE arguments");
+            }
+            const char *value = argv[i + 1];
+            if (option == "--save") {
+                args.saveFile = value;
+            } else if (option == "--seed") {
+                args.seed = number(option, value);
+            } else if (option == "--rank") {
+                args.rank = number(option, value);
+            } else if (option == "--world-size") {
+                args.worldSize = number(option, value);
+            } else if (option == "--transport") {
+                args.transport = value;
+            } else if (option == "--dist-addr") {
+                args.distAddress = value;
+            } else if (option == "--profile") {
+                args.profileFile = value;
+            } else if (option == "--telemetry") {
+                args.telemetryFile = value;
+            } else {
+                throw std::runtime_error("Unknown training option: " + option);
+            }
+            i += 2;
+        }
+        if (args.worldSize == 0 || args.rank >= args.worldSize) {
+            throw std::runtime_error("--rank must be lower than --world-size");
+        }
+        return i;
+    }
 };
@@ -0,0 +1,192 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** CheckpointWriter
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace lava {
+
+/**
+ *  @brief Replaces @param path by @param size bytes of @param data, so that a crash leaves either the
+ *         old or the new file, never a partial one.
+ *
+ *  The data goes to a temporary file which is fsynced, then renamed over @param path.
+ *
+ *  @param keep Number of checkpoints kept: before the rename, path.1 becomes path.2, ... up to
+ *              path.(keep - 1), and path.1 becomes a hard link to path (a copy where links are not
+ *              supported). path itself stays in place until the rename replaces it.
+ */
+inline void writeFileAtomically(const std::string &path, const char *data, size_t size, size_t keep = 1)
+{
+    std::string temporary = path + ".tmp";
+    int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Could not create network file: " + temporary);
+    }
+    size_t written = 0;
+    while (written < size) {
+        ssize_t n = ::write(fd, data + written, size - written);
+        if (n < 0) {
+            ::close(fd);
+            ::unlink(temporary.c_str());
+            throw std::runtime_error("Could not write network file: " + temporary);
+        }
+        written += static_cast<size_t>(n);
+    }
+    if (::fsync(fd) != 0 || ::close(fd) != 0) {
+        ::unlink(temporary.c_str());
+        throw std::runtime_error("Could not sync network file: " + temporary);
+    }
+
+    for (size_t i = keep; i-- > 2;) {
+        std::string older = path + "." + std::to_string(i);
+        std::string newer = path + "." + std::to_string(i - 1);
+        std::rename(newer.c_str(), older.c_str());
+    }
+    if (keep > 1 && std::filesystem::exists(path)) {
+        std::string previous = path + ".1";
+        ::unlink(previous.c_str());
+        if (::link(path.c_str(), previous.c_str()) != 0) {
+            std::error_code error;
+            std::filesystem::copy_file(path, previous, std::filesystem::copy_options::overwrite_existing, error);
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        ::unlink(temporary.c_str());
+        throw std::runtime_error("Could not rename " + temporary + " to " + path);
+    }
+
+    // Makes the rename itself durable
+    std::string directory = path.find('/') == std::string::npos ? "." : path.substr(0, path.rfind('/') + 1);
+    int dirFd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dirFd >= 0) {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+}
+
+/**
+ *  @brief Writes checkpoints on a background thread, the training only pays for serializing them in memory.
+ *
+ *  A checkpoint submitted while an older one of the same path is still queued replaces it: only the most
+ *  recent state matters, and the queue never grows when the disk is slower than the training.
+ *
+ *  NOTE: A failed write is reported by the next call to submit() or flush().
+ */
+class CheckpointWriter {
+    public:
+    CheckpointWriter() : _worker(&CheckpointWriter::run, this) {}
+
+    CheckpointWriter(const CheckpointWriter &) = delete;
+    CheckpointWriter &operator=(const CheckpointWriter &) = delete;
+
+    ~CheckpointWriter()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+        _condition.notify_all();
+        _worker.join();
+    }
+
+    /**
+     *  @brief Queues @param image, the whole content of the file @param path.
+     *
+     *  @param keep Rotating checkpoints kept for @param path (see writeFileAtomically()).
+     */
+    void submit(const std::string &path, std::string image, size_t keep = 1)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        rethrow();
+        for (auto &job : _queue) {
+            if (job.path == path) {
+                job.image = std::move(image);
+                job.keep = keep;
+                return;
+            }
+        }
+        _queue.push_back({path, std::move(image), keep});
+        _condition.notify_all();
+    }
+
+    /**
+     *  @brief Waits until every queued checkpoint is on disk.
+     */
+    void flush()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _condition.wait(lock, [this] { return _queue.empty() && !_writing; });
+        rethrow();
+    }
+
+    private:
+    struct Job {
+        std::string path;
+        std::string image;
+        size_t keep;
+    };
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true) {
+            _condition.wait(lock, [this] { return _stopping || !_queue.empty(); });
+            if (_queue.empty()) {
+                return; // Stopping, everything was written
+            }
+            auto job = std::move(_queue.front());
+            _queue.pop_front();
+            _writing = true;
+            lock.unlock();
+
+            std::exception_ptr error;
+            try {
+                writeFileAtomically(job.path, job.image.data(), job.image.size(), job.keep);
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            lock.lock();
+            _writing = false;
+            if (error && !_error) {
+                _error = error;
+            }
+            _condition.notify_all();
+        }
+    }
+
+    void rethrow()
+    {
+        if (_error) {
+            auto error = std::exchange(_error, nullptr);
+            std::rethrow_exception(error);
+        }
+    }
+
+    std::deque<Job> _queue;
+    bool _writing{false};
+    bool _stopping{false};
+    std::exception_ptr _error;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::thread _worker;
+};
+
+} // namespace lava
@@ -10,6 +10,7 @@
 #include "FenConverter.hpp"
 #include "FenValidator.hpp"
 #include "FileHandler.hpp"
+#include "Profiler/Profiler.hpp"
 
 #include <string>
 #include <vector>
@@ -26,6 +27,7 @@ class ChessboardParser {
 
     static std::vector<ChessboardData> parseChessboardFile(const std::string &filename)
     {
+        lava::profiler::Scope profile("ChessboardParser::parseChessboardFile");
         std::vector<ChessboardData> boards;
         auto lines = FileHandler::readLines(filename);
 
@@ -0,0 +1,70 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** MappedFile
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace lava {
+
+/**
+ *  @brief Read-only memory mapping of a whole file, unmapped on destruction.
+ */
+class MappedFile {
+    public:
+    explicit MappedFile(const std::string &path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Could not open network file: " + path);
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+            ::close(fd);
+            throw std::runtime_error("Could not stat network file: " + path);
+        }
+        _size = static_cast<size_t>(st.st_size);
+        _data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (_data == MAP_FAILED) {
+            _data = nullptr;
+            throw std::runtime_error("Could not map network file: " + path);
+        }
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    ~MappedFile()
+    {
+        if (_data) {
+            ::munmap(_data, _size);
+        }
+    }
+
+    const char *data() const
+    {
+        return static_cast<const char *>(_data);
+    }
+
+    size_t size() const
+    {
+        return _size;
+    }
+
+    private:
+    void *_data{nullptr};
+    size_t _size{0};
+};
+
+} // namespace lava
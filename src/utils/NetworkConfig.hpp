@@ -9,6 +9,8 @@
 
 #include <cstdint>
 #include <fstream>
+#include <iomanip>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -27,6 +29,11 @@ enum class BiasInit {
     UNIFORM
 };
 
+enum class DataType {
+    FLOAT64,
+    FLOAT32
+};
+
 class NetworkConfig {
     public:
     struct Architecture {
@@ -34,6 +41,7 @@ class NetworkConfig {
         size_t hiddenLayers{};
         std::vector<size_t> hiddenSizes;
         size_t outputSize{};
+        DataType dtype{DataType::FLOAT64};
     };
 
     struct Hyperparameters {
@@ -43,6 +51,9 @@ class NetworkConfig {
         double dropout{};
         size_t epochs{};
         size_t samplesPerEpoch{};
+        size_t accumulationSteps{1};
+        std::string trainingMode{"sync"};
+        size_t recomputeSegment{0};
     };
 
     struct Initialization {
@@ -56,19 +67,67 @@ class NetworkConfig {
         double decayRate{0.95};
         size_t decaySteps{100};
         double minLR{0.0001};
+        size_t warmupSteps{0};
+        double pctStart{0.3};
+        size_t patience{5};
+    };
+
+    struct Optimizer {
+        std::string type{"sgd"};
+        double momentum{0.9};
+        double beta1{0.9};
+        double beta2{0.999};
+        double epsilon{1e-8};
+        double weightDecay{0.0};
+        double gradClip{1.0};
+    };
+
+    struct Sampler {
+        std::string type{"shuffle"};
+        double balance{0.0};
+    };
+
+    struct Validation {
+        double split{0.0};
+        size_t patience{0};
+        double minDelta{0.0};
+    };
+
+    struct Checkpoint {
+        size_t interval{10};
+        size_t keep{1};
+    };
+
+    struct MixedPrecision {
+        std::string type{"none"};
+        double lossScale{65536.0};
+        size_t growthInterval{2000};
     };
 
     static NetworkConfig fromFile(const std::string &filename)
     {
-        NetworkConfig config;
         std::ifstream file(filename);
         if (!file.is_open()) {
             throw std::runtime_error("Could not open config file: " + filename);
         }
+        return fromStream(file);
+    }
+
+    /**
+     *  @brief Parses a configuration from its `.conf` text, as written by toString().
+     */
+    static NetworkConfig fromString(const std::string &content)
+    {
+        std::istringstream stream(content);
+        return fromStream(stream);
+    }
 
+    static NetworkConfig fromStream(std::istream &stream)
+    {
+        NetworkConfig config;
         std::string line;
         std::string currentSection;
-        while (std::getline(file, line)) {
+        while (std::getline(stream, line)) {
             if (line.empty() || line[0] == '#') {
                 continue;
             }
@@ -89,6 +148,92 @@ class NetworkConfig {
         return config;
     }
 
+    /**
+     *  @brief Serializes the configuration back to the `.conf` text format.
+     *
+     *  NOTE: Floating point values are written with full precision so fromString() gives back
+     *        exactly the same configuration.
+     */
+    std::string toString() const
+    {
+        std::ostringstream out;
+        out << std::setprecision(std::numeric_limits<double>::max_digits10);
+
+        out << "[architecture]\n";
+        out << "input_size=" << _architecture.inputSize << "\n";
+        out << "hidden_layers=" << _architecture.hiddenLayers << "\n";
+        out << "hidden_sizes=";
+        for (size_t i = 0; i < _architecture.hiddenSizes.size(); i++) {
+            out << (i ? "," : "") << _architecture.hiddenSizes[i];
+        }
+        out << "\n";
+        out << "output_size=" << _architecture.outputSize << "\n";
+        out << "dtype=" << (_architecture.dtype == DataType::FLOAT32 ? "float32" : "float64") << "\n\n";
+
+        out << "[hyperparameters]\n";
+        out << "learning_rate=" << _hyperparameters.learningRate << "\n";
+        out << "batch_size=" << _hyperparameters.batchSize << "\n";
+        out << "activation=" << _hyperparameters.activation << "\n";
+        out << "dropout=" << _hyperparameters.dropout << "\n";
+        out << "epochs=" << _hyperparameters.epochs << "\n";
+        out << "samples_per_epoch=" << _hyperparameters.samplesPerEpoch << "\n";
+        out << "accumulation_steps=" << _hyperparameters.accumulationSteps << "\n";
+        out << "training_mode=" << _hyperparameters.trainingMode << "\n";
+        out << "recompute_segment=" << _hyperparameters.recomputeSegment << "\n\n";
+
+        out << "[initialization]\n";
+        switch (_initialization.weightInit) {
+            case WeightInit::XAVIER:
+                out << "weight_init=xavier\n";
+                break;
+            case WeightInit::HE:
+                out << "weight_init=he\n";
+                break;
+            case WeightInit::UNIFORM:
+                out << "weight_init=uniform\n";
+                break;
+        }
+        out << "bias_init=" << (_initialization.biasInit == BiasInit::ZEROS ? "zeros" : "uniform") << "\n\n";
+
+        out << "[lr_scheduler]\n";
+        out << "type=" << _lrScheduler.type << "\n";
+        out << "initial_lr=" << _lrScheduler.initialLR << "\n";
+        out << "decay_rate=" << _lrScheduler.decayRate << "\n";
+        out << "decay_steps=" << _lrScheduler.decaySteps << "\n";
+        out << "min_lr=" << _lrScheduler.minLR << "\n";
+        out << "warmup_steps=" << _lrScheduler.warmupSteps << "\n";
+        out << "pct_start=" << _lrScheduler.pctStart << "\n";
+        out << "patience=" << _lrScheduler.patience << "\n\n";
+
+        out << "[optimizer]\n";
+        out << "type=" << _optimizer.type << "\n";
+        out << "momentum=" << _optimizer.momentum << "\n";
+        out << "beta1=" << _optimizer.beta1 << "\n";
+        out << "beta2=" << _optimizer.beta2 << "\n";
+        out << "epsilon=" << _optimizer.epsilon << "\n";
+        out << "weight_decay=" << _optimizer.weightDecay << "\n";
+        out << "grad_clip=" << _optimizer.gradClip << "\n\n";
+
+        out << "[sampler]\n";
+        out << "type=" << _sampler.type << "\n";
+        out << "balance=" << _sampler.balance << "\n\n";
+
+        out << "[validation]\n";
+        out << "split=" << _validation.split << "\n";
+        out << "patience=" << _validation.patience << "\n";
+        out << "min_delta=" << _validation.minDelta << "\n\n";
+
+        out << "[checkpoint]\n";
+        out << "interval=" << _checkpoint.interval << "\n";
+        out << "keep=" << _checkpoint.keep << "\n\n";
+
+        out << "[mixed_precision]\n";
+        out << "type=" << _mixedPrecision.type << "\n";
+        out << "loss_scale=" << _mixedPrecision.lossScale << "\n";
+        out << "growth_interval=" << _mixedPrecision.growthInterval << "\n";
+        return out.str();
+    }
+
     static NetworkConfig fromBinaryFile(std::ifstream &file)
     {
         NetworkConfig config;
@@ -146,6 +291,14 @@ class NetworkConfig {
         return _architecture;
     }
 
+    /**
+     *  @brief Changes the weights data type, used when converting a network file.
+     */
+    void setDataType(DataType dtype)
+    {
+        _architecture.dtype = dtype;
+    }
+
     const Hyperparameters &hyperparameters() const
     {
         return _hyperparameters;
@@ -161,6 +314,31 @@ class NetworkConfig {
         return _lrScheduler;
     }
 
+    const Optimizer &optimizer() const
+    {
+        return _optimizer;
+    }
+
+    const Sampler &sampler() const
+    {
+        return _sampler;
+    }
+
+    const Validation &validation() const
+    {
+        return _validation;
+    }
+
+    const Checkpoint &checkpoint() const
+    {
+        return _checkpoint;
+    }
+
+    const MixedPrecision &mixedPrecision() const
+    {
+        return _mixedPrecision;
+    }
+
     std::string getValue(const std::string &section, const std::string &key) const
     {
         if (section == "lr_scheduler") {
@@ -176,6 +354,15 @@ class NetworkConfig {
             if (key == "min_lr") {
                 return std::to_string(_lrScheduler.minLR);
             }
+            if (key == "warmup_steps") {
+                return std::to_string(_lrScheduler.warmupSteps);
+            }
+            if (key == "pct_start") {
+                return std::to_string(_lrScheduler.pctStart);
+            }
+            if (key == "patience") {
+                return std::to_string(_lrScheduler.patience);
+            }
         }
         throw std::runtime_error("Invalid section or key: " + section + "." + key);
     }
@@ -185,6 +372,11 @@ class NetworkConfig {
     Hyperparameters _hyperparameters;
     Initialization _initialization{};
     LearningRateScheduler _lrScheduler{};
+    Optimizer _optimizer{};
+    Sampler _sampler{};
+    Validation _validation{};
+    Checkpoint _checkpoint{};
+    MixedPrecision _mixedPrecision{};
 
     void _parseKeyValue(const std::string &section, const std::string &key, const std::string &value)
     {
@@ -196,6 +388,16 @@ class NetworkConfig {
             _parseInitialization(key, value);
         } else if (section == "lr_scheduler") {
             _parseLRScheduler(key, value);
+        } else if (section == "optimizer") {
+            _parseOptimizer(key, value);
+        } else if (section == "sampler") {
+            _parseSampler(key, value);
+        } else if (section == "validation") {
+            _parseValidation(key, value);
+        } else if (section == "checkpoint") {
+            _parseCheckpoint(key, value);
+        } else if (section == "mixed_precision") {
+            _parseMixedPrecision(key, value);
         }
     }
 
@@ -206,6 +408,8 @@ class NetworkConfig {
         } else if (key == "hidden_layers") {
             _architecture.hiddenLayers = std::stoul(value);
         } else if (key == "hidden_sizes") {
+            // A later line replaces the sizes, as for every other key
+            _architecture.hiddenSizes.clear();
             std::stringstream ss(value);
             std::string size;
             while (std::getline(ss, size, ',')) {
@@ -213,6 +417,14 @@ class NetworkConfig {
             }
         } else if (key == "output_size") {
             _architecture.outputSize = std::stoul(value);
+        } else if (key == "dtype") {
+            if (value == "float64" || value == "double") {
+                _architecture.dtype = DataType::FLOAT64;
+            } else if (value == "float32" || value == "float") {
+                _architecture.dtype = DataType::FLOAT32;
+            } else {
+                throw std::runtime_error("Invalid dtype (must be float64 or float32): " + value);
+            }
         }
     }
 
@@ -230,6 +442,12 @@ class NetworkConfig {
             _hyperparameters.epochs = std::stoul(value);
         } else if (key == "samples_per_epoch") {
             _hyperparameters.samplesPerEpoch = std::stoul(value);
+        } else if (key == "accumulation_steps") {
+            _hyperparameters.accumulationSteps = std::stoul(value);
+        } else if (key == "training_mode") {
+            _hyperparameters.trainingMode = value;
+        } else if (key == "recompute_segment") {
+            _hyperparameters.recomputeSegment = std::stoul(value);
         }
     }
 
@@ -264,6 +482,71 @@ class NetworkConfig {
             _lrScheduler.decaySteps = std::stoul(value);
         } else if (key == "min_lr") {
             _lrScheduler.minLR = std::stod(value);
+        } else if (key == "warmup_steps") {
+            _lrScheduler.warmupSteps = std::stoul(value);
+        } else if (key == "pct_start") {
+            _lrScheduler.pctStart = std::stod(value);
+        } else if (key == "patience") {
+            _lrScheduler.patience = std::stoul(value);
+        }
+    }
+
+    void _parseOptimizer(const std::string &key, const std::string &value)
+    {
+        if (key == "type") {
+            _optimizer.type = value;
+        } else if (key == "momentum") {
+            _optimizer.momentum = std::stod(value);
+        } else if (key == "beta1") {
+            _optimizer.beta1 = std::stod(value);
+        } else if (key == "beta2") {
+            _optimizer.beta2 = std::stod(value);
+        } else if (key == "epsilon") {
+            _optimizer.epsilon = std::stod(value);
+        } else if (key == "weight_decay") {
+            _optimizer.weightDecay = std::stod(value);
+        } else if (key == "grad_clip") {
+            _optimizer.gradClip = std::stod(value);
+        }
+    }
+
+    void _parseSampler(const std::string &key, const std::string &value)
+    {
+        if (key == "type") {
+            _sampler.type = value;
+        } else if (key == "balance") {
+            _sampler.balance = std::stod(value);
+        }
+    }
+
+    void _parseValidation(const std::string &key, const std::string &value)
+    {
+        if (key == "split") {
+            _validation.split = std::stod(value);
+        } else if (key == "patience") {
+            _validation.patience = std::stoul(value);
+        } else if (key == "min_delta") {
+            _validation.minDelta = std::stod(value);
+        }
+    }
+
+    void _parseCheckpoint(const std::string &key, const std::string &value)
+    {
+        if (key == "interval") {
+            _checkpoint.interval = std::stoul(value);
+        } else if (key == "keep") {
+            _checkpoint.keep = std::stoul(value);
+        }
+    }
+
+    void _parseMixedPrecision(const std::string &key, const std::string &value)
+    {
+        if (key == "type") {
+            _mixedPrecision.type = value;
+        } else if (key == "loss_scale") {
+            _mixedPrecision.lossScale = std::stod(value);
+        } else if (key == "growth_interval") {
+            _mixedPrecision.growthInterval = std::stoul(value);
         }
     }
 
@@ -284,13 +567,23 @@ class NetworkConfig {
         if (_hyperparameters.batchSize == 0) {
             throw std::runtime_error("Batch size must be greater than 0");
         }
+        if (_hyperparameters.accumulationSteps == 0) {
+            throw std::runtime_error("Accumulation steps must be greater than 0");
+        }
+        if (_hyperparameters.trainingMode != "sync" && _hyperparameters.trainingMode != "hogwild") {
+            throw std::runtime_error("Training mode must be sync or hogwild");
+        }
         if (_hyperparameters.dropout < 0 || _hyperparameters.dropout >= 1) {
             throw std::runtime_error("Dropout must be between 0 and 1");
         }
 
         // Validate learning rate scheduler
-        if (_lrScheduler.type != "none" && _lrScheduler.type != "exponential") {
-            throw std::runtime_error("Invalid learning rate scheduler type");
+        const auto &scheduler = _lrScheduler.type;
+        if (scheduler != "none" && scheduler != "exponential" && scheduler != "step" && scheduler != "cosine" &&
+            scheduler != "one_cycle" && scheduler != "plateau") {
+            throw std::runtime_error(
+                "Invalid learning rate scheduler type (must be none, exponential, step, cosine, one_cycle or plateau)"
+            );
         }
         if (_lrScheduler.decayRate <= 0 || _lrScheduler.decayRate > 1) {
             throw std::runtime_error("Decay rate must be between 0 and 1");
@@ -301,6 +594,67 @@ class NetworkConfig {
         if (_lrScheduler.minLR < 0) {
             throw std::runtime_error("Minimum learning rate must be non-negative");
         }
+        if (_lrScheduler.pctStart <= 0 || _lrScheduler.pctStart >= 1) {
+            throw std::runtime_error("One-cycle pct_start must be between 0 and 1");
+        }
+        if (_lrScheduler.patience == 0) {
+            throw std::runtime_error("Plateau patience must be greater than 0");
+        }
+
+        // Validate optimizer
+        const auto &type = _optimizer.type;
+        if (type != "sgd" && type != "momentum" && type != "nesterov" && type != "adam" && type != "adamw") {
+            throw std::runtime_error("Invalid optimizer type (must be sgd, momentum, nesterov, adam or adamw)");
+        }
+        if (_optimizer.momentum < 0 || _optimizer.momentum >= 1) {
+            throw std::runtime_error("Momentum must be between 0 and 1");
+        }
+        if (_optimizer.beta1 < 0 || _optimizer.beta1 >= 1 || _optimizer.beta2 < 0 || _optimizer.beta2 >= 1) {
+            throw std::runtime_error("Adam betas must be between 0 and 1");
+        }
+        if (_optimizer.epsilon <= 0) {
+            throw std::runtime_error("Optimizer epsilon must be greater than 0");
+        }
+        if (_optimizer.weightDecay < 0) {
+            throw std::runtime_error("Weight decay must be non-negative");
+        }
+        if (_optimizer.gradClip <= 0) {
+            throw std::runtime_error("Gradient clipping bound must be greater than 0");
+        }
+
+        // Validate sampler
+        if (_sampler.type != "shuffle" && _sampler.type != "stratified") {
+            throw std::runtime_error("Invalid sampler type (must be shuffle or stratified)");
+        }
+        if (_sampler.balance < 0 || _sampler.balance > 1) {
+            throw std::runtime_error("Sampler balance must be between 0 and 1");
+        }
+
+        // Validate validation split
+        if (_validation.split < 0 || _validation.split >= 1) {
+            throw std::runtime_error("Validation split must be between 0 and 1");
+        }
+        if (_validation.minDelta < 0) {
+            throw std::runtime_error("Validation min_delta must be non-negative");
+        }
+        if (_checkpoint.keep == 0) {
+            throw std::runtime_error("At least one checkpoint must be kept");
+        }
+
+        // Validate mixed precision
+        const auto &precision = _mixedPrecision.type;
+        if (precision != "none" && precision != "bf16" && precision != "fp16") {
+            throw std::runtime_error("Invalid mixed precision type (must be none, bf16 or fp16)");
+        }
+        if (precision != "none" && _architecture.dtype != DataType::FLOAT32) {
+            throw std::runtime_error("Mixed precision needs float32 master weights (dtype=float32)");
+        }
+        if (precision != "none" && _hyperparameters.trainingMode != "sync") {
+            throw std::runtime_error("Mixed precision only supports the sync training mode");
+        }
+        if (_mixedPrecision.lossScale < 1) {
+            throw std::runtime_error("Loss scale must be at least 1");
+        }
     }
 };
 
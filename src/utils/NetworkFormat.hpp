@@ -0,0 +1,130 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** NetworkFormat
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ *  Layout of a version 2 `.nn` file:
+ *
+ *  [Header (128 bytes)]
+ *  [Config: the network configuration as `.conf` text]
+ *  [Layer table: numLayers LayerEntry]
+ *  [Data: every weight and bias blob, each one starting on a 64-byte boundary]
+ *  [Optimizer state (optional): OptimizerHeader, then the flat state blob]
+ *  [Training state (optional): TrainingStateHeader, then the sampler and scheduler state texts]
+ *
+ *  All offsets are absolute offsets in the file, so the data section can be memory-mapped
+ *  and used in place by the tensors. The optimizer state, stored with the weights data type,
+ *  is only present in training checkpoints (optimizerOffset is 0 otherwise), like the training
+ *  state which holds the progress of the training loop (trainingStateOffset is 0 otherwise).
+ *
+ *  In INT8 files (quantized networks) a Linear weights blob holds the transposed int8 weights,
+ *  one row of int8PaddedSize(inputSize) bytes per output, and the biases blob holds float32
+ *  [biases (outputSize) | weight scales (outputSize) | input scale (1)].
+ */
+namespace lava::format {
+
+constexpr char MAGIC[] = "LAVA";
+constexpr uint32_t VERSION_1 = 1;
+constexpr uint32_t VERSION_2 = 2;
+constexpr uint64_t ALIGNMENT = 64;
+
+enum class DType : uint32_t {
+    FLOAT64 = 0,
+    FLOAT32 = 1,
+    INT8 = 2
+};
+
+enum class LayerType : uint32_t {
+    LINEAR = 1,
+    RELU = 2,
+    SOFTMAX = 3
+};
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint64_t archHash;
+    uint32_t numLayers;
+    uint32_t dtype;
+    uint64_t configOffset;
+    uint64_t configSize;
+    uint64_t layerTableOffset;
+    uint64_t dataOffset;
+    uint64_t dataSize;
+    uint64_t optimizerOffset;
+    uint64_t optimizerSize;
+    uint64_t trainingStateOffset;
+    uint64_t trainingStateSize;
+    char reserved[32];
+};
+
+static_assert(sizeof(Header) == 128, "Version 2 header must stay 128 bytes");
+
+struct LayerEntry {
+    uint32_t type_raw;
+    uint32_t inputSize;
+    uint32_t outputSize;
+    uint32_t activation;
+    uint64_t weightsOffset;
+    uint64_t biasesOffset;
+
+    LayerType type() const
+    {
+        return static_cast<LayerType>(type_raw);
+    }
+};
+
+static_assert(sizeof(LayerEntry) == 32, "Version 2 layer entry must stay 32 bytes");
+
+struct OptimizerHeader {
+    uint32_t type;        /** nn::OptimizerType */
+    uint32_t stateSlots;  /** Number of state values per parameter */
+    uint64_t steps;
+    uint64_t stateCount;  /** Number of elements of the state blob */
+    uint64_t stateOffset;
+};
+
+static_assert(sizeof(OptimizerHeader) == 32, "Version 2 optimizer header must stay 32 bytes");
+
+struct TrainingStateHeader {
+    uint64_t epoch;             /** Epochs completed */
+    uint64_t seed;              /** Seed of the validation split and of the sampler */
+    double bestLoss;            /** Best validation loss, infinity when there was no validation */
+    double bestAccuracy;
+    uint64_t bestEpoch;
+    uint64_t staleValidations;  /** Validations since the best one */
+    uint64_t samplerStateOffset;
+    uint64_t samplerStateSize;
+    uint64_t schedulerStateOffset;
+    uint64_t schedulerStateSize;
+};
+
+static_assert(sizeof(TrainingStateHeader) == 80, "Version 2 training state header must stay 80 bytes");
+
+template <typename T>
+constexpr DType dtypeOf()
+{
+    static_assert(std::is_same_v<T, double> || std::is_same_v<T, float>, "Only float64 and float32 weights");
+    return std::is_same_v<T, double> ? DType::FLOAT64 : DType::FLOAT32;
+}
+
+inline size_t dtypeSize(DType dtype)
+{
+    return dtype == DType::FLOAT32 ? sizeof(float) : sizeof(double);
+}
+
+inline uint64_t alignUp(uint64_t offset)
+{
+    return (offset + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+} // namespace lava::format
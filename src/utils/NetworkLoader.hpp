@@ -7,61 +7,200 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <memory>
+#include <optional>
 #include <vector>
+#include "Profiler/Profiler.hpp"
 #include "nn/Linear.hpp"
+#include "nn/Optimizer.hpp"
+#include "nn/QuantizedSequential.hpp"
 #include "nn/ReLU.hpp"
 #include "nn/Sequential.hpp"
 #include "nn/Softmax.hpp"
+#include "utils/MappedFile.hpp"
 #include "utils/NetworkConfig.hpp"
+#include "utils/NetworkFormat.hpp"
+#include "utils/TrainingState.hpp"
 
 namespace lava {
 
 class NetworkLoader {
     public:
-    static std::shared_ptr<nn::Sequential<double>> loadNetwork(const std::string &path)
+    /**
+     *  @brief Loads a network from a `.nn` file, version 1 or 2.
+     *
+     *  @tparam T Type of the weights in memory. When it differs from the file data type
+     *            (see readDType()) the weights are converted while loading.
+     *  @param path Path of the network file
+     *  @param readOnly When true, a version 2 file is memory-mapped and the layers use the mapped weights
+     *                  in place, without gradient buffers. The network must then only be used for inference.
+     */
+    template <typename T>
+    static std::shared_ptr<nn::Sequential<T>> loadNetwork(const std::string &path, bool readOnly = false)
     {
-        std::ifstream file(path, std::ios::binary);
-        if (!file.is_open()) {
-            throw std::runtime_error("Could not open network file: " + path);
-        }
+        profiler::Scope profile("NetworkLoader::loadNetwork");
+        uint32_t version = readVersion(path);
 
-        // Read and validate header
-        Header header{};
-        file.read(reinterpret_cast<char *>(&header), sizeof(header));
-        if (std::memcmp(header.magic, MAGIC, 4) != 0) {
-            throw std::runtime_error("Invalid network file format");
+        if (version == format::VERSION_2) {
+            return loadNetworkV2<T>(path, readOnly);
         }
-        if (header.version != VERSION) {
-            throw std::runtime_error("Unsupported network file version");
+        if (version == format::VERSION_1) {
+            return loadNetworkV1<T>(path);
         }
+        throw std::runtime_error("Unsupported network file version");
+    }
 
-        config = NetworkConfig::fromBinaryFile(file);
+    /**
+     *  @brief Loads an INT8 network written by NetworkSaver::saveQuantizedNetwork().
+     *
+     *  NOTE: The file is memory-mapped and the int8 weights are used in place.
+     */
+    static nn::QuantizedSequential loadQuantizedNetwork(const std::string &path)
+    {
+        if (readVersion(path) != format::VERSION_2 || readDType(path) != format::DType::INT8) {
+            throw std::runtime_error("Not a quantized network file: " + path);
+        }
 
-        std::vector<std::shared_ptr<nn::Module<double>>> modules;
-        for (uint32_t i = 0; i < header.numLayers; i++) {
-            LayerHeader layerHeader{};
-            file.read(reinterpret_cast<char *>(&layerHeader), sizeof(layerHeader));
+        auto mapping = std::make_shared<MappedFile>(path);
+        format::Header header{};
+        std::memcpy(&header, mapping->data(), sizeof(header));
+        checkRange(*mapping, header.configOffset, header.configSize);
+        checkRange(*mapping, header.layerTableOffset, header.numLayers * sizeof(format::LayerEntry));
+        config = NetworkConfig::fromString(std::string(mapping->data() + header.configOffset, header.configSize));
 
-            switch (layerHeader.type()) {
-                case LayerType::LINEAR:
-                    modules.push_back(readLinearLayer(file, layerHeader));
-                    break;
-                case LayerType::RELU:
-                    modules.push_back(std::make_shared<nn::ReLU<double>>());
-                    break;
-                case LayerType::SOFTMAX:
-                    modules.push_back(std::make_shared<nn::Softmax<double>>());
-                    break;
-                default:
-                    throw std::runtime_error("Unknown layer type");
+        std::vector<format::LayerEntry> entries(header.numLayers);
+        std::memcpy(entries.data(), mapping->data() + header.layerTableOffset, entries.size() * sizeof(entries[0]));
+
+        nn::QuantizedSequential network;
+        for (size_t i = 0; i < entries.size(); i++) {
+            const auto &entry = entries[i];
+            if (entry.type() == format::LayerType::RELU) {
+                continue;
             }
+            if (entry.type() != format::LayerType::LINEAR) {
+                throw std::runtime_error("Unsupported layer type in a quantized network");
+            }
+
+            size_t stride = kernels::int8PaddedSize(entry.inputSize);
+            size_t weightsCount = stride * entry.outputSize;
+            checkRange(*mapping, entry.weightsOffset, weightsCount);
+            checkRange(*mapping, entry.biasesOffset, (2 * entry.outputSize + 1) * sizeof(float));
+
+            auto *weights = reinterpret_cast<const int8_t *>(mapping->data() + entry.weightsOffset);
+            auto *floats = reinterpret_cast<const float *>(mapping->data() + entry.biasesOffset);
+            float inputScale = floats[2 * entry.outputSize];
+
+            bool relu = i + 1 < entries.size() && entries[i + 1].type() == format::LayerType::RELU;
+            network.addLayer(
+                nn::QuantizedLinear(
+                    entry.inputSize,
+                    entry.outputSize,
+                    Storage<int8_t>::readOnlyView(weights, weightsCount, mapping),
+                    Storage<float>::readOnlyView(floats, entry.outputSize, mapping),
+                    Storage<float>::readOnlyView(floats + entry.outputSize, entry.outputSize, mapping),
+                    inputScale
+                ),
+                relu
+            );
         }
+        return network;
+    }
 
-        file.close();
-        return std::make_shared<nn::Sequential<double>>(modules);
+    /**
+     *  @brief Restores the optimizer state saved in a version 2 checkpoint.
+     *
+     *  @return False when the file holds no state, or a state of another optimizer type: @param optimizer
+     *          is then left untouched and starts from scratch.
+     */
+    template <typename T>
+    static bool loadOptimizerState(const std::string &path, nn::Optimizer<T> &optimizer)
+    {
+        if (readVersion(path) != format::VERSION_2) {
+            return false;
+        }
+
+        MappedFile mapping(path);
+        format::Header header{};
+        checkRange(mapping, 0, sizeof(header));
+        std::memcpy(&header, mapping.data(), sizeof(header));
+        if (header.optimizerOffset == 0) {
+            return false;
+        }
+
+        format::OptimizerHeader optimizerHeader{};
+        checkRange(mapping, header.optimizerOffset, sizeof(optimizerHeader));
+        std::memcpy(&optimizerHeader, mapping.data() + header.optimizerOffset, sizeof(optimizerHeader));
+        if (static_cast<nn::OptimizerType>(optimizerHeader.type) != optimizer.type()) {
+            return false;
+        }
+        if (optimizerHeader.stateCount != optimizer.state().size()) {
+            throw std::runtime_error("Optimizer state does not match the network in " + path);
+        }
+
+        auto dtype = static_cast<format::DType>(header.dtype);
+        checkRange(mapping, optimizerHeader.stateOffset, optimizerHeader.stateCount * format::dtypeSize(dtype));
+        optimizer.state() =
+            convertBlob<T>(mapping.data() + optimizerHeader.stateOffset, optimizerHeader.stateCount, dtype);
+        optimizer.setSteps(optimizerHeader.steps);
+        return true;
+    }
+
+    /**
+     *  @brief Reads the progress of the training loop saved in the checkpoint @param path.
+     *
+     *  @return Nothing when the file holds no training state.
+     */
+    static std::optional<TrainingState> loadTrainingState(const std::string &path)
+    {
+        if (readVersion(path) != format::VERSION_2) {
+            return std::nullopt;
+        }
+
+        MappedFile mapping(path);
+        format::Header header{};
+        checkRange(mapping, 0, sizeof(header));
+        std::memcpy(&header, mapping.data(), sizeof(header));
+        if (header.trainingStateOffset == 0) {
+            return std::nullopt;
+        }
+
+        format::TrainingStateHeader stateHeader{};
+        checkRange(mapping, header.trainingStateOffset, sizeof(stateHeader));
+        std::memcpy(&stateHeader, mapping.data() + header.trainingStateOffset, sizeof(stateHeader));
+        checkRange(mapping, stateHeader.samplerStateOffset, stateHeader.samplerStateSize);
+        checkRange(mapping, stateHeader.schedulerStateOffset, stateHeader.schedulerStateSize);
+
+        TrainingState state;
+        state.epoch = stateHeader.epoch;
+        state.seed = stateHeader.seed;
+        state.bestLoss = stateHeader.bestLoss;
+        state.bestAccuracy = stateHeader.bestAccuracy;
+        state.bestEpoch = stateHeader.bestEpoch;
+        state.staleValidations = stateHeader.staleValidations;
+        state.samplerState.assign(mapping.data() + stateHeader.samplerStateOffset, stateHeader.samplerStateSize);
+        state.schedulerState.assign(mapping.data() + stateHeader.schedulerStateOffset, stateHeader.schedulerStateSize);
+        return state;
+    }
+
+    /**
+     *  @brief Data type of the weights stored in a network file. Version 1 files are always float64.
+     */
+    static format::DType readDType(const std::string &path)
+    {
+        if (readVersion(path) != format::VERSION_2) {
+            return format::DType::FLOAT64;
+        }
+
+        std::ifstream file(path, std::ios::binary);
+        format::Header header{};
+        file.read(reinterpret_cast<char *>(&header), sizeof(header));
+        if (!file) {
+            throw std::runtime_error("Invalid network file: truncated header");
+        }
+        return static_cast<format::DType>(header.dtype);
     }
 
     static const NetworkConfig &getLastLoadedConfig()
@@ -107,6 +246,191 @@ class NetworkLoader {
         }
     } __attribute__((packed));
 
+    template <typename T>
+    static std::shared_ptr<nn::Sequential<T>> loadNetworkV1(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open network file: " + path);
+        }
+
+        // Read and validate header
+        Header header{};
+        file.read(reinterpret_cast<char *>(&header), sizeof(header));
+        if (std::memcmp(header.magic, MAGIC, 4) != 0) {
+            throw std::runtime_error("Invalid network file format");
+        }
+        if (header.version != VERSION) {
+            throw std::runtime_error("Unsupported network file version");
+        }
+
+        config = NetworkConfig::fromBinaryFile(file);
+
+        std::vector<std::shared_ptr<nn::Module<T>>> modules;
+        for (uint32_t i = 0; i < header.numLayers; i++) {
+            LayerHeader layerHeader{};
+            file.read(reinterpret_cast<char *>(&layerHeader), sizeof(layerHeader));
+
+            switch (layerHeader.type()) {
+                case LayerType::LINEAR:
+                    modules.push_back(readLinearLayer<T>(file, layerHeader));
+                    break;
+                case LayerType::RELU:
+                    modules.push_back(std::make_shared<nn::ReLU<T>>());
+                    break;
+                case LayerType::SOFTMAX:
+                    modules.push_back(std::make_shared<nn::Softmax<T>>());
+                    break;
+                default:
+                    throw std::runtime_error("Unknown layer type");
+            }
+        }
+
+        file.close();
+        return std::make_shared<nn::Sequential<T>>(modules);
+    }
+
+    template <typename T>
+    static std::shared_ptr<nn::Sequential<T>> loadNetworkV2(const std::string &path, bool readOnly)
+    {
+        auto mapping = std::make_shared<MappedFile>(path);
+        if (mapping->size() < sizeof(format::Header)) {
+            throw std::runtime_error("Invalid network file: truncated header");
+        }
+
+        format::Header header{};
+        std::memcpy(&header, mapping->data(), sizeof(header));
+        checkRange(*mapping, header.configOffset, header.configSize);
+        checkRange(*mapping, header.layerTableOffset, header.numLayers * sizeof(format::LayerEntry));
+        checkRange(*mapping, header.dataOffset, header.dataSize);
+        if (header.numLayers == 0) {
+            throw std::runtime_error("Invalid network file: no layers");
+        }
+        auto dtype = static_cast<format::DType>(header.dtype);
+        if (dtype == format::DType::INT8) {
+            throw std::runtime_error("Quantized networks can only be used with --predict");
+        }
+        if (dtype != format::DType::FLOAT64 && dtype != format::DType::FLOAT32) {
+            throw std::runtime_error("Unsupported network file data type");
+        }
+
+        config = NetworkConfig::fromString(std::string(mapping->data() + header.configOffset, header.configSize));
+
+        std::vector<std::shared_ptr<nn::Module<T>>> modules;
+        for (uint32_t i = 0; i < header.numLayers; i++) {
+            format::LayerEntry entry{};
+            std::memcpy(
+                &entry, mapping->data() + header.layerTableOffset + i * sizeof(format::LayerEntry), sizeof(entry)
+            );
+
+            switch (entry.type()) {
+                case format::LayerType::LINEAR:
+                    modules.push_back(mapLinearLayer<T>(mapping, entry, dtype, readOnly));
+                    break;
+                case format::LayerType::RELU:
+                    modules.push_back(std::make_shared<nn::ReLU<T>>());
+                    break;
+                case format::LayerType::SOFTMAX:
+                    modules.push_back(std::make_shared<nn::Softmax<T>>());
+                    break;
+                default:
+                    throw std::runtime_error("Unknown layer type");
+            }
+        }
+        return std::make_shared<nn::Sequential<T>>(modules);
+    }
+
+    static uint32_t readVersion(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open network file: " + path);
+        }
+
+        char magic[4] = {};
+        uint32_t version = 0;
+        file.read(magic, sizeof(magic));
+        file.read(reinterpret_cast<char *>(&version), sizeof(version));
+        if (!file || std::memcmp(magic, format::MAGIC, 4) != 0) {
+            throw std::runtime_error("Invalid network file format");
+        }
+        return version;
+    }
+
+    static void checkRange(const MappedFile &mapping, uint64_t offset, uint64_t size)
+    {
+        if (offset > mapping.size() || size > mapping.size() - offset) {
+            throw std::runtime_error("Invalid network file: section out of bounds");
+        }
+    }
+
+    /**
+     *  @brief Copies @param count elements stored as @param dtype in a storage of @tparam T.
+     */
+    template <typename T>
+    static Storage<T> convertBlob(const char *src, size_t count, format::DType dtype)
+    {
+        Storage<T> storage(count);
+
+        if (dtype == format::dtypeOf<T>()) {
+            std::memcpy(storage.data(), src, count * sizeof(T));
+        } else if (dtype == format::DType::FLOAT64) {
+            const auto *values = reinterpret_cast<const double *>(src);
+            std::transform(values, values + count, storage.begin(), [](double v) { return static_cast<T>(v); });
+        } else {
+            const auto *values = reinterpret_cast<const float *>(src);
+            std::transform(values, values + count, storage.begin(), [](float v) { return static_cast<T>(v); });
+        }
+        return storage;
+    }
+
+    /**
+     *  @brief Builds a Linear layer on the weights of a mapped version 2 file.
+     *
+     *  In read-only mode, when the file data type matches @tparam T, the tensors are views on the
+     *  mapping (which they keep alive). Otherwise the weights are copied (and converted) once
+     *  in owned, writable buffers.
+     */
+    template <typename T>
+    static std::shared_ptr<nn::Linear<T>> mapLinearLayer(
+        const std::shared_ptr<MappedFile> &mapping,
+        const format::LayerEntry &entry,
+        format::DType dtype,
+        bool readOnly
+    )
+    {
+        size_t weightsCount = static_cast<size_t>(entry.inputSize) * entry.outputSize;
+        size_t biasesCount = entry.outputSize;
+
+        checkRange(*mapping, entry.weightsOffset, weightsCount * format::dtypeSize(dtype));
+        checkRange(*mapping, entry.biasesOffset, biasesCount * format::dtypeSize(dtype));
+        if (entry.weightsOffset % format::ALIGNMENT != 0 || entry.biasesOffset % format::ALIGNMENT != 0) {
+            throw std::runtime_error("Invalid network file: unaligned weights");
+        }
+
+        const char *weightsPtr = mapping->data() + entry.weightsOffset;
+        const char *biasesPtr = mapping->data() + entry.biasesOffset;
+
+        Storage<T> weights;
+        Storage<T> biases;
+        if (readOnly && dtype == format::dtypeOf<T>()) {
+            // The mapping is read-only, the weights are read-only views on it
+            weights = Storage<T>::readOnlyView(reinterpret_cast<const T *>(weightsPtr), weightsCount, mapping);
+            biases = Storage<T>::readOnlyView(reinterpret_cast<const T *>(biasesPtr), biasesCount, mapping);
+        } else {
+            weights = convertBlob<T>(weightsPtr, weightsCount, dtype);
+            biases = convertBlob<T>(biasesPtr, biasesCount, dtype);
+        }
+
+        std::vector<int> weightsShape = {static_cast<int>(entry.inputSize), static_cast<int>(entry.outputSize)};
+        std::vector<int> biasesShape = {static_cast<int>(entry.outputSize)};
+        return std::make_shared<nn::Linear<T>>(
+            TensorArray<T>(weightsShape, std::move(weights)),
+            TensorArray<T>(biasesShape, std::move(biases)),
+            !readOnly
+        );
+    }
+
     static void validateHeader(const Header &header)
     {
         if (std::memcmp(header.magic, MAGIC, 4) != 0) {
@@ -120,15 +444,28 @@ class NetworkLoader {
         }
     }
 
-    static std::shared_ptr<nn::Linear<double>> readLinearLayer(std::ifstream &file, const LayerHeader &header)
+    template <typename T>
+    static std::shared_ptr<nn::Linear<T>> readLinearLayer(std::ifstream &file, const LayerHeader &header)
     {
-        auto layer = std::make_shared<nn::Linear<double>>(header.inputSize, header.outputSize);
+        auto layer = std::make_shared<nn::Linear<T>>(
+            header.inputSize, header.outputSize, TensorArray<T>::InitType::UNINITIALIZED
+        );
 
-        auto &weights = layer->_weights.tensor().datas();
-        file.read(reinterpret_cast<char *>(weights.data()), weights.size() * sizeof(double));
+        // Version 1 files always store float64 weights
+        auto readInto = [&file](Storage<T> &datas) {
+            if constexpr (std::is_same_v<T, double>) {
+                file.read(reinterpret_cast<char *>(datas.data()), datas.size() * sizeof(double));
+            } else {
+                std::vector<double> values(datas.size());
+                file.read(reinterpret_cast<char *>(values.data()), values.size() * sizeof(double));
+                std::transform(values.begin(), values.end(), datas.begin(), [](double v) {
+                    return static_cast<T>(v);
+                });
+            }
+        };
 
-        auto &biases = layer->_biases.tensor().datas();
-        file.read(reinterpret_cast<char *>(biases.data()), biases.size() * sizeof(double));
+        readInto(layer->_weights.tensor().datas());
+        readInto(layer->_biases.tensor().datas());
         return layer;
     }
 };
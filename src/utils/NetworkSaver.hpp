@@ -12,174 +12,288 @@
 #include <memory>
 #include <vector>
 #include "nn/Linear.hpp"
+#include "nn/Optimizer.hpp"
+#include "nn/QuantizedSequential.hpp"
 #include "nn/ReLU.hpp"
 #include "nn/Sequential.hpp"
 #include "nn/Softmax.hpp"
+#include "utils/CheckpointWriter.hpp"
 #include "utils/NetworkConfig.hpp"
+#include "utils/NetworkFormat.hpp"
 #include "utils/NetworkLoader.hpp"
+#include "utils/TrainingState.hpp"
 
 namespace lava {
 
+/**
+ *  @brief Writes networks in the version 2 `.nn` format (see NetworkFormat.hpp).
+ */
 class NetworkSaver {
     public:
-    static void saveNetwork(const std::shared_ptr<nn::Sequential<double>> &network, const std::string &filename)
+    template <typename T>
+    static void saveNetwork(const std::shared_ptr<nn::Sequential<T>> &network, const std::string &filename)
+    {
+        saveNetwork(network, filename, NetworkLoader::getLastLoadedConfig());
+    }
+
+    /**
+     *  @brief Writes @param network with its @param config. The weights are stored as @tparam T,
+     *         the dtype of the written config is updated accordingly.
+     *
+     *  @param optimizer When given, its state is written too so the training can be resumed exactly
+     *                   (see NetworkLoader::loadOptimizerState()).
+     *
+     *  NOTE: The file is replaced atomically, see writeFileAtomically().
+     */
+    template <typename T>
+    static void saveNetwork(
+        const std::shared_ptr<nn::Sequential<T>> &network,
+        const std::string &filename,
+        const NetworkConfig &config,
+        const nn::Optimizer<T> *optimizer = nullptr
+    )
+    {
+        std::string image = serializeNetwork(network, config, optimizer);
+        writeFileAtomically(filename, image.data(), image.size());
+    }
+
+    /**
+     *  @brief Builds the whole `.nn` file of @param network in memory, see saveNetwork().
+     *
+     *  @param trainingState When given, the progress of the training loop is written too
+     *                       (see NetworkLoader::loadTrainingState()).
+     *
+     *  NOTE: The image is a snapshot: it can be written later, by another thread, while the
+     *        network keeps training.
+     */
+    template <typename T>
+    static std::string serializeNetwork(
+        const std::shared_ptr<nn::Sequential<T>> &network,
+        NetworkConfig config,
+        const nn::Optimizer<T> *optimizer = nullptr,
+        const TrainingState *trainingState = nullptr
+    )
+    {
+        const auto &layers = network->layers();
+        auto &parameters = network->parameters();
+        config.setDataType(format::dtypeOf<T>() == format::DType::FLOAT32 ? DataType::FLOAT32 : DataType::FLOAT64);
+        std::string configText = config.toString();
+
+        format::Header header{};
+        std::memcpy(header.magic, format::MAGIC, 4);
+        header.version = format::VERSION_2;
+        header.archHash = computeArchHash(network);
+        header.numLayers = countLayers(network);
+        header.dtype = static_cast<uint32_t>(format::dtypeOf<T>());
+        header.configOffset = sizeof(format::Header);
+        header.configSize = configText.size();
+        header.layerTableOffset = format::alignUp(header.configOffset + header.configSize);
+        header.dataOffset = format::alignUp(header.layerTableOffset + layers.size() * sizeof(format::LayerEntry));
+
+        // The parameter arena already has the layout of the data section: one blob per tensor,
+        // each one on a 64-byte boundary
+        std::vector<format::LayerEntry> entries;
+        for (const auto &layer : layers) {
+            format::LayerEntry entry{};
+            if (auto linear = std::dynamic_pointer_cast<nn::Linear<T>>(layer)) {
+                entry.type_raw = static_cast<uint32_t>(format::LayerType::LINEAR);
+                entry.inputSize = static_cast<uint32_t>(linear->_weights.tensor().shape()[0]);
+                entry.outputSize = static_cast<uint32_t>(linear->_weights.tensor().shape()[1]);
+                entry.weightsOffset = header.dataOffset + parameters.offsetOf(linear->_weights) * sizeof(T);
+                entry.biasesOffset = header.dataOffset + parameters.offsetOf(linear->_biases) * sizeof(T);
+            } else if (std::dynamic_pointer_cast<nn::ReLU<T>>(layer)) {
+                entry.type_raw = static_cast<uint32_t>(format::LayerType::RELU);
+            } else if (std::dynamic_pointer_cast<nn::Softmax<T>>(layer)) {
+                entry.type_raw = static_cast<uint32_t>(format::LayerType::SOFTMAX);
+            }
+            entries.push_back(entry);
+        }
+        header.dataSize = parameters.size() * sizeof(T);
+        uint64_t offset = header.dataOffset + header.dataSize;
+
+        format::OptimizerHeader optimizerHeader{};
+        if (optimizer) {
+            const auto &state = optimizer->state();
+            optimizerHeader.type = static_cast<uint32_t>(optimizer->type());
+            optimizerHeader.stateSlots =
+                optimizer->parameterCount() ? static_cast<uint32_t>(state.size() / optimizer->parameterCount()) : 0;
+            optimizerHeader.steps = optimizer->steps();
+            optimizerHeader.stateCount = state.size();
+            optimizerHeader.stateOffset = format::alignUp(offset + sizeof(optimizerHeader));
+            header.optimizerOffset = offset;
+            offset = format::alignUp(optimizerHeader.stateOffset + state.size() * sizeof(T));
+            header.optimizerSize = offset - header.optimizerOffset;
+        }
+
+        format::TrainingStateHeader stateHeader{};
+        if (trainingState) {
+            stateHeader.epoch = trainingState->epoch;
+            stateHeader.seed = trainingState->seed;
+            stateHeader.bestLoss = trainingState->bestLoss;
+            stateHeader.bestAccuracy = trainingState->bestAccuracy;
+            stateHeader.bestEpoch = trainingState->bestEpoch;
+            stateHeader.staleValidations = trainingState->staleValidations;
+            stateHeader.samplerStateOffset = offset + sizeof(stateHeader);
+            stateHeader.samplerStateSize = trainingState->samplerState.size();
+            stateHeader.schedulerStateOffset = stateHeader.samplerStateOffset + stateHeader.samplerStateSize;
+            stateHeader.schedulerStateSize = trainingState->schedulerState.size();
+            header.trainingStateOffset = offset;
+            offset = format::alignUp(stateHeader.schedulerStateOffset + stateHeader.schedulerStateSize);
+            header.trainingStateSize = offset - header.trainingStateOffset;
+        }
+
+        // One allocation, the padding is zero-filled by the resizes
+        std::string image;
+        image.reserve(offset);
+        append(image, &header, sizeof(header));
+        append(image, configText.data(), configText.size());
+        image.resize(header.layerTableOffset);
+        append(image, entries.data(), entries.size() * sizeof(format::LayerEntry));
+        image.resize(header.dataOffset);
+        append(image, parameters.datas(), header.dataSize);
+        if (optimizer) {
+            const auto &state = optimizer->state();
+            image.resize(header.optimizerOffset);
+            append(image, &optimizerHeader, sizeof(optimizerHeader));
+            image.resize(optimizerHeader.stateOffset);
+            append(image, state.data(), state.size() * sizeof(T));
+        }
+        if (trainingState) {
+            image.resize(header.trainingStateOffset);
+            append(image, &stateHeader, sizeof(stateHeader));
+            append(image, trainingState->samplerState.data(), trainingState->samplerState.size());
+            append(image, trainingState->schedulerState.data(), trainingState->schedulerState.size());
+        }
+        image.resize(offset);
+        return image;
+    }
+
+    /**
+     *  @brief Writes a quantized network as an INT8 version 2 file (see NetworkFormat.hpp).
+     */
+    static void saveQuantizedNetwork(
+        const nn::QuantizedSequential &network,
+        const std::string &filename,
+        const NetworkConfig &config
+    )
     {
         std::ofstream file(filename, std::ios::binary);
         if (!file.is_open()) {
             throw std::runtime_error("Could not create network file: " + filename);
         }
 
-        Header header{};
-        std::memcpy(header.magic, MAGIC, 4);
-        header.version = VERSION;
-        header.archHash = computeArchHash(network);
-        header.numLayers = countLayers(network);
-        std::memset(header.reserved, 0, sizeof(header.reserved));
+        const auto &layers = network.layers();
+        std::string configText = config.toString();
 
-        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        std::vector<format::LayerEntry> entries;
+        for (size_t i = 0; i < layers.size(); i++) {
+            format::LayerEntry entry{};
+            entry.type_raw = static_cast<uint32_t>(format::LayerType::LINEAR);
+            entry.inputSize = static_cast<uint32_t>(layers[i].inFeatures());
+            entry.outputSize = static_cast<uint32_t>(layers[i].outFeatures());
+            entries.push_back(entry);
+            if (network.hasRelu(i)) {
+                format::LayerEntry relu{};
+                relu.type_raw = static_cast<uint32_t>(format::LayerType::RELU);
+                entries.push_back(relu);
+            }
+        }
 
-        auto config = NetworkLoader::getLastLoadedConfig();
-        ConfigHeader configHeader{};
-
-        size_t hyperparamsPos = static_cast<size_t>(file.tellp());
-        file.write(reinterpret_cast<const char *>(&configHeader), sizeof(ConfigHeader)); // Placeholder
-
-        const auto &hyperparams = config.hyperparameters();
-        file.write(reinterpret_cast<const char *>(&hyperparams.learningRate), sizeof(double));
-        file.write(reinterpret_cast<const char *>(&hyperparams.batchSize), sizeof(uint32_t));
-        file.write(reinterpret_cast<const char *>(&hyperparams.dropout), sizeof(double));
-        file.write(reinterpret_cast<const char *>(&hyperparams.epochs), sizeof(uint32_t));
-        file.write(reinterpret_cast<const char *>(&hyperparams.samplesPerEpoch), sizeof(uint32_t));
-        configHeader.hyperparamsSize =
-            static_cast<uint32_t>(static_cast<size_t>(file.tellp()) - hyperparamsPos - sizeof(ConfigHeader));
-
-        const auto &arch = config.architecture();
-        size_t archPos = static_cast<size_t>(file.tellp());
-        file.write(reinterpret_cast<const char *>(&arch.inputSize), sizeof(uint32_t));
-        file.write(reinterpret_cast<const char *>(&arch.outputSize), sizeof(uint32_t));
-        file.write(reinterpret_cast<const char *>(&arch.hiddenLayers), sizeof(uint32_t));
-        auto numSizes = static_cast<uint32_t>(arch.hiddenSizes.size());
-        file.write(reinterpret_cast<const char *>(&numSizes), sizeof(uint32_t));
-        for (const auto &size : arch.hiddenSizes) {
-            file.write(reinterpret_cast<const char *>(&size), sizeof(uint32_t));
+        format::Header header{};
+        std::memcpy(header.magic, format::MAGIC, 4);
+        header.version = format::VERSION_2;
+        header.archHash = 0;
+        for (const auto &layer : layers) {
+            header.archHash = header.archHash * 31 + layer.inFeatures();
+            header.archHash = header.archHash * 31 + layer.outFeatures();
+        }
+        header.numLayers = static_cast<uint32_t>(entries.size());
+        header.dtype = static_cast<uint32_t>(format::DType::INT8);
+        header.configOffset = sizeof(format::Header);
+        header.configSize = configText.size();
+        header.layerTableOffset = format::alignUp(header.configOffset + header.configSize);
+        header.dataOffset = format::alignUp(header.layerTableOffset + entries.size() * sizeof(format::LayerEntry));
+
+        uint64_t offset = header.dataOffset;
+        size_t layer = 0;
+        for (auto &entry : entries) {
+            if (entry.type() != format::LayerType::LINEAR) {
+                continue;
+            }
+            entry.weightsOffset = offset;
+            offset = format::alignUp(offset + layers[layer].weights().size());
+            entry.biasesOffset = offset;
+            offset = format::alignUp(offset + (2 * layers[layer].outFeatures() + 1) * sizeof(float));
+            layer++;
         }
-        configHeader.archSize = static_cast<uint32_t>(static_cast<size_t>(file.tellp()) - archPos);
-
-        const auto &init = config.initialization();
-        size_t initPos = static_cast<size_t>(file.tellp());
-        file.write(reinterpret_cast<const char *>(&init.weightInit), sizeof(WeightInit));
-        file.write(reinterpret_cast<const char *>(&init.biasInit), sizeof(BiasInit));
-        configHeader.initSize = static_cast<uint32_t>(static_cast<size_t>(file.tellp()) - initPos);
-
-        const auto &lrScheduler = config.lrScheduler();
-        size_t lrPos = static_cast<size_t>(file.tellp());
-        uint32_t typeLen = static_cast<uint32_t>(lrScheduler.type.length());
-        file.write(reinterpret_cast<const char *>(&typeLen), sizeof(uint32_t));
-        file.write(lrScheduler.type.c_str(), typeLen);
-        file.write(reinterpret_cast<const char *>(&lrScheduler.decayRate), sizeof(double));
-        file.write(reinterpret_cast<const char *>(&lrScheduler.decaySteps), sizeof(uint32_t));
-        file.write(reinterpret_cast<const char *>(&lrScheduler.minLR), sizeof(double));
-        configHeader.lrSchedulerSize = static_cast<uint32_t>(static_cast<size_t>(file.tellp()) - lrPos);
-
-        auto currentPos = file.tellp();
-        file.seekp(hyperparamsPos);
-        file.write(reinterpret_cast<const char *>(&configHeader), sizeof(ConfigHeader));
-        file.seekp(currentPos);
-
-        for (const auto &layer : network->layers()) {
-            if (auto linear = std::dynamic_pointer_cast<nn::Linear<double>>(layer)) {
-                writeLinearLayer(file, linear);
-            } else if (auto relu = std::dynamic_pointer_cast<nn::ReLU<double>>(layer)) {
-                writeReluLayer(file);
-            } else if (auto softmax = std::dynamic_pointer_cast<nn::Softmax<double>>(layer)) {
-                writeSoftmaxLayer(file);
+        header.dataSize = offset - header.dataOffset;
+
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(configText.data(), static_cast<std::streamsize>(configText.size()));
+        writePadding(file, header.layerTableOffset);
+        file.write(
+            reinterpret_cast<const char *>(entries.data()),
+            static_cast<std::streamsize>(entries.size() * sizeof(format::LayerEntry))
+        );
+
+        layer = 0;
+        for (const auto &entry : entries) {
+            if (entry.type() != format::LayerType::LINEAR) {
+                continue;
             }
+            const auto &quantized = layers[layer++];
+            float inputScale = quantized.inputScale();
+
+            writePadding(file, entry.weightsOffset);
+            file.write(reinterpret_cast<const char *>(quantized.weights().data()), quantized.weights().size());
+            writePadding(file, entry.biasesOffset);
+            const auto floatsSize = static_cast<std::streamsize>(quantized.outFeatures() * sizeof(float));
+            file.write(reinterpret_cast<const char *>(quantized.biases().data()), floatsSize);
+            file.write(reinterpret_cast<const char *>(quantized.weightScales().data()), floatsSize);
+            file.write(reinterpret_cast<const char *>(&inputScale), sizeof(float));
         }
+        writePadding(file, offset);
 
         file.close();
+        if (!file) {
+            throw std::runtime_error("Could not write network file: " + filename);
+        }
     }
 
     private:
-    static constexpr char MAGIC[] = "LAVA";
-    static constexpr uint32_t VERSION = 1;
-
-    struct Header {
-        char magic[4];
-        uint32_t version;
-        uint64_t archHash;
-        uint32_t numLayers;
-        char reserved[12];
-    } __attribute__((packed));
-
-    struct ConfigHeader {
-        uint32_t hyperparamsSize;
-        uint32_t archSize;
-        uint32_t initSize;
-        uint32_t lrSchedulerSize;
-    } __attribute__((packed));
-
-    enum class LayerType : uint32_t {
-        LINEAR = 1,
-        RELU = 2,
-        SOFTMAX = 3
-    };
-
-    struct LayerHeader {
-        uint32_t type_raw; // Store as raw uint32_t instead of enum
-        uint32_t inputSize;
-        uint32_t outputSize;
-        uint32_t activation;
-
-        LayerHeader(LayerType t, uint32_t in, uint32_t out, uint32_t act)
-            : type_raw(static_cast<uint32_t>(t)), inputSize(in), outputSize(out), activation(act)
-        {
-        }
-    } __attribute__((packed));
-
-    static uint64_t computeArchHash(const std::shared_ptr<nn::Sequential<double>> &network)
+    template <typename T>
+    static uint64_t computeArchHash(const std::shared_ptr<nn::Sequential<T>> &network)
     {
         uint64_t hash = 0;
-        for (const auto &layer : network->layers()) {
-            if (auto linear = std::dynamic_pointer_cast<nn::Linear<double>>(layer)) {
-                hash = hash * 31 + linear->_weights.tensor().shape()[0];
-                hash = hash * 31 + linear->_weights.tensor().shape()[1];
+        for (const auto *tensor : network->parameters().tensors()) {
+            // Only the weight matrices define the architecture
+            if (tensor->shape().size() == 2) {
+                hash = hash * 31 + tensor->shape()[0];
+                hash = hash * 31 + tensor->shape()[1];
             }
         }
         return hash;
     }
 
-    static uint32_t countLayers(const std::shared_ptr<nn::Sequential<double>> &network)
+    template <typename T>
+    static uint32_t countLayers(const std::shared_ptr<nn::Sequential<T>> &network)
     {
         return network->layers().size();
     }
 
-    static void writeLinearLayer(std::ofstream &file, const std::shared_ptr<nn::Linear<double>> &layer)
+    static void append(std::string &image, const void *data, size_t size)
     {
-        LayerHeader header(
-            LayerType::LINEAR,
-            static_cast<uint32_t>(layer->_weights.tensor().shape()[0]),
-            static_cast<uint32_t>(layer->_weights.tensor().shape()[1]),
-            0
-        );
-
-        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
-        const auto &weights = layer->_weights.tensor().datas();
-        file.write(reinterpret_cast<const char *>(weights.data()), weights.size() * sizeof(double));
-
-        const auto &biases = layer->_biases.tensor().datas();
-        file.write(reinterpret_cast<const char *>(biases.data()), biases.size() * sizeof(double));
+        image.append(static_cast<const char *>(data), size);
     }
 
-    static void writeReluLayer(std::ofstream &file)
+    static void writePadding(std::ofstream &file, uint64_t offset)
     {
-        LayerHeader header(LayerType::RELU, 0, 0, 0);
-        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
-    }
+        static const char zeros[format::ALIGNMENT] = {};
+        auto current = static_cast<uint64_t>(file.tellp());
 
-    static void writeSoftmaxLayer(std::ofstream &file)
-    {
-        LayerHeader header(LayerType::SOFTMAX, 0, 0, 0);
-        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        if (current < offset) {
+            file.write(zeros, static_cast<std::streamsize>(offset - current));
+        }
     }
 };
 
@@ -0,0 +1,126 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** Quantizer
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "ChessboardParser.hpp"
+#include "FenConverter.hpp"
+#include "nn/Linear.hpp"
+#include "nn/QuantizedSequential.hpp"
+#include "nn/ReLU.hpp"
+#include "nn/Sequential.hpp"
+
+namespace lava {
+
+/**
+ *  @brief Post-training int8 quantization of Linear/ReLU networks.
+ */
+class Quantizer {
+    public:
+    struct Report {
+        size_t samples{0};
+        size_t labeled{0};
+        size_t floatCorrect{0};
+        size_t int8Correct{0};
+        size_t agreements{0}; /** Positions where both models predict the same class */
+    };
+
+    /**
+     *  @brief Quantizes @param model, calibrating the input scale of every Linear layer
+     *         with the largest activation seen on the @param calibration positions.
+     */
+    template <typename T>
+    static nn::QuantizedSequential quantize(
+        nn::Sequential<T> &model,
+        const std::vector<ChessboardParser::ChessboardData> &calibration
+    )
+    {
+        if (calibration.empty()) {
+            throw std::runtime_error("Quantization needs at least one calibration position");
+        }
+
+        const auto &layers = model.layers();
+        std::vector<T> inputMax(layers.size(), T{0});
+        for (const auto &board : calibration) {
+            Tensor<T> current(toTensor<T>(board));
+            for (size_t i = 0; i < layers.size(); i++) {
+                if (std::dynamic_pointer_cast<nn::Linear<T>>(layers[i])) {
+                    const auto &datas = current.datas();
+                    if (*std::min_element(datas.begin(), datas.end()) < 0) {
+                        throw std::runtime_error("Quantized Linear layers need non-negative inputs");
+                    }
+                    inputMax[i] = std::max(inputMax[i], *std::max_element(datas.begin(), datas.end()));
+                }
+                current = layers[i]->forward(current);
+            }
+        }
+
+        nn::QuantizedSequential quantized;
+        for (size_t i = 0; i < layers.size(); i++) {
+            auto linear = std::dynamic_pointer_cast<nn::Linear<T>>(layers[i]);
+            if (!linear) {
+                if (!std::dynamic_pointer_cast<nn::ReLU<T>>(layers[i])) {
+                    throw std::runtime_error("Only Linear and ReLU layers can be quantized");
+                }
+                continue;
+            }
+            bool relu = i + 1 < layers.size() && std::dynamic_pointer_cast<nn::ReLU<T>>(layers[i + 1]);
+            quantized.addLayer(nn::QuantizedLinear::fromLinear(*linear, static_cast<float>(inputMax[i])), relu);
+        }
+        return quantized;
+    }
+
+    /**
+     *  @brief Compares the predictions of @param model and its quantized version on @param boards.
+     */
+    template <typename T>
+    static Report evaluate(
+        nn::Sequential<T> &model,
+        const nn::QuantizedSequential &quantized,
+        const std::vector<ChessboardParser::ChessboardData> &boards
+    )
+    {
+        Report report;
+
+        for (const auto &board : boards) {
+            Tensor<T> input(toTensor<T>(board));
+            auto output = model.forward(input);
+            size_t floatClass = output.argmax();
+
+            auto logits = quantized.forward(board.boardData);
+            size_t int8Class = std::distance(logits.begin(), std::max_element(logits.begin(), logits.end()));
+
+            report.samples++;
+            report.agreements += floatClass == int8Class;
+            double label = board.expectedOutput.empty() ? -1 : FenConverter::convertBoardLabel(board.expectedOutput);
+            if (label >= 0) {
+                report.labeled++;
+                report.floatCorrect += floatClass == static_cast<size_t>(label);
+                report.int8Correct += int8Class == static_cast<size_t>(label);
+            }
+        }
+        return report;
+    }
+
+    private:
+    template <typename T>
+    static TensorArray<T> toTensor(const ChessboardParser::ChessboardData &board)
+    {
+        std::vector<int> shape = {1, static_cast<int>(board.boardData.size())};
+        std::vector<int> strides = {static_cast<int>(board.boardData.size()), 1};
+        TensorArray<T> array(shape, strides, TensorArray<T>::InitType::UNINITIALIZED);
+
+        std::copy(board.boardData.begin(), board.boardData.end(), array.datas().begin());
+        return array;
+    }
+};
+
+} // namespace lava
@@ -0,0 +1,31 @@
+/*
+** EPITECH PROJECT, 2024
+** LavaTensor
+** File description:
+** TrainingState
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+namespace lava {
+
+/**
+ *  @brief Progress of a training loop, stored in checkpoints next to the optimizer state so an
+ *         interrupted training can be resumed where it stopped (see `--resume`).
+ */
+struct TrainingState {
+    uint64_t epoch{0}; /** Epochs completed */
+    uint64_t seed{0};
+    double bestLoss{std::numeric_limits<double>::infinity()};
+    double bestAccuracy{0.0};
+    uint64_t bestEpoch{0};
+    uint64_t staleValidations{0};
+    std::string samplerState; /** Sampler::state(), with its random generator */
+    std::string schedulerState; /** LRScheduler::state(), empty in checkpoints written without one */
+};
+
+} // namespace lava